@@ -0,0 +1,120 @@
+/*
+ * Copyright 2025 8dcc
+ *
+ * This file is part of 8dcc's Chess.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include <pthread.h>
+
+#include "include/analysis.h"
+#include "include/board.h"
+#include "include/clock.h"
+#include "include/profile.h"
+#include "include/search.h"
+#include "include/timeman.h"
+
+/*
+ * Publish the result of a completed iteration of the analysis search. Called
+ * from the analysis thread.
+ */
+static void publish_result(const SearchResult* result, void* data) {
+    Analysis* analysis = data;
+
+    pthread_mutex_lock(&analysis->mutex);
+    analysis->result = *result;
+    analysis->generation++;
+    pthread_mutex_unlock(&analysis->mutex);
+}
+
+/*
+ * Entry point of the analysis thread. Iterative deepening until the maximum
+ * depth is reached, until the analysis is stopped, or until the time manager
+ * stops it if there is a clock.
+ */
+static void* analysis_main(void* arg) {
+    Analysis* analysis = arg;
+
+    TimeManager timeman;
+    if (analysis->use_clock)
+        timeman_init(&timeman, &analysis->clock, analysis->turn);
+
+    SearchResult result;
+    search_run(&analysis->search,
+               analysis->use_clock ? &timeman : NULL,
+               SEARCH_MAX_PLY - 1,
+               &result,
+               publish_result,
+               analysis);
+
+    profile_merge_thread();
+    return NULL;
+}
+
+/*----------------------------------------------------------------------------*/
+
+bool analysis_start(Analysis* analysis, const Board* board, size_t num_lines,
+                    const GameClock* clock) {
+    if (!search_init(&analysis->search, board, num_lines))
+        return false;
+
+    analysis->use_clock = (clock != NULL);
+    if (clock != NULL)
+        analysis->clock = *clock;
+    analysis->turn = board->turn;
+
+    analysis->hash             = board->hash;
+    analysis->result.depth     = 0;
+    analysis->result.nodes     = 0;
+    analysis->result.num_lines = 0;
+    analysis->generation       = 0;
+
+    if (pthread_mutex_init(&analysis->mutex, NULL) != 0) {
+        search_destroy(&analysis->search);
+        return false;
+    }
+
+    if (pthread_create(&analysis->thread, NULL, analysis_main, analysis) != 0) {
+        pthread_mutex_destroy(&analysis->mutex);
+        search_destroy(&analysis->search);
+        return false;
+    }
+
+    return true;
+}
+
+void analysis_stop(Analysis* analysis) {
+    search_stop(&analysis->search);
+    pthread_join(analysis->thread, NULL);
+
+    pthread_mutex_destroy(&analysis->mutex);
+    search_destroy(&analysis->search);
+}
+
+bool analysis_poll(Analysis* analysis, SearchResult* dst,
+                   unsigned* generation) {
+    pthread_mutex_lock(&analysis->mutex);
+
+    const bool updated = (analysis->generation != *generation);
+    if (updated) {
+        *dst        = analysis->result;
+        *generation = analysis->generation;
+    }
+
+    pthread_mutex_unlock(&analysis->mutex);
+    return updated;
+}
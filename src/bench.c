@@ -0,0 +1,487 @@
+/*
+ * Copyright 2025 8dcc
+ *
+ * This file is part of 8dcc's Chess.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <string.h>
+
+#include "include/board.h"
+#include "include/clock.h"
+#include "include/move.h"
+#include "include/render.h"
+#include "include/search.h"
+#include "include/timeman.h"
+#include "include/util.h"
+
+/*
+ * Number of iterations of the FEN and rendering benchmarks.
+ */
+#define FEN_ITERATIONS    200000
+#define RENDER_ITERATIONS 2000
+
+/*
+ * Depth and number of lines of the multi-PV search benchmark.
+ */
+#define SEARCH_DEPTH 5
+#define SEARCH_LINES 3
+
+/*
+ * Time of the fixed-time search benchmark, in milliseconds, and the factor of
+ * its hard deadline after which it fails. Smaller overruns are only reported,
+ * since they depend on the load of the machine.
+ */
+#define TIMED_SEARCH_MS         200
+#define TIMED_SEARCH_MAX_FACTOR 2
+
+/*
+ * Base time of the clock used by the clock search benchmark, in milliseconds,
+ * and its position, where the knight can capture a free queen. The best move is
+ * found quickly and never changes, so the search should stop long before its
+ * soft deadline, because of the stability of the best move.
+ */
+#define CLOCK_SEARCH_BASE_MS 60000
+#define CLOCK_SEARCH_FEN \
+    "r3k2r/ppp2ppp/8/3q4/8/4N3/PPP2PPP/R3K2R w KQkq - 0 1"
+#define CLOCK_SEARCH_BEST "e3d5"
+
+/*
+ * Structure representing a position of the perft benchmark, along with the
+ * expected number of nodes at the specified depth.
+ */
+typedef struct {
+    const char* name;
+    const char* fen;
+    int depth;
+    uint64_t expected;
+} BenchPosition;
+
+/*
+ * Positions used in the perft benchmark. The first one is the standard initial
+ * position, and the rest are common positions for testing the move generation.
+ * The last one is a Chess960 position, with the king and the rooks outside of
+ * their standard columns.
+ */
+static const BenchPosition g_positions[] = {
+    {
+      .name     = "initial",
+      .fen      = "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+      .depth    = 5,
+      .expected = 4865609,
+    },
+    {
+      .name     = "kiwipete",
+      .fen      = "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w "
+                  "KQkq - 0 1",
+      .depth    = 4,
+      .expected = 4085603,
+    },
+    {
+      .name     = "endgame",
+      .fen      = "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+      .depth    = 5,
+      .expected = 674624,
+    },
+    {
+      .name     = "promotions",
+      .fen      = "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq "
+                  "- 0 1",
+      .depth    = 4,
+      .expected = 422333,
+    },
+    {
+      .name     = "middlegame",
+      .fen      = "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+      .depth    = 4,
+      .expected = 2103487,
+    },
+    {
+      .name     = "chess960",
+      .fen      = "bqnb1rkr/pp3ppp/3ppn2/2p5/5P2/P2P4/NPP1P1PP/BQ1BNRKR w "
+                  "KQkq - 2 9",
+      .depth    = 4,
+      .expected = 326672,
+    },
+};
+
+/*----------------------------------------------------------------------------*/
+
+/*
+ * Return the number of operations per second, given the number of operations
+ * and the elapsed milliseconds.
+ */
+static inline double per_second(uint64_t count, int64_t elapsed_ms) {
+    return (elapsed_ms <= 0) ? 0.0 : count * 1000.0 / elapsed_ms;
+}
+
+/*
+ * Check that the FEN strings of all benchmark positions are valid, so the
+ * benchmarks don't need to stop in the middle of their JSON output.
+ */
+static bool validate_positions(Board* board) {
+    bool result = true;
+
+    for (size_t i = 0; i < ARRLEN(g_positions); i++) {
+        if (!board_set_fen(board, g_positions[i].fen)) {
+            fprintf(stderr, "Invalid benchmark FEN: %s\n", g_positions[i].fen);
+            result = false;
+        }
+    }
+
+    return result;
+}
+
+/*
+ * Run the perft benchmark on each position, printing a JSON array with the
+ * results. The total number of nodes is added to 'signature'.
+ *
+ * Returns true if all node counts matched the expected ones.
+ */
+static bool bench_perft(Board* board, uint64_t* signature) {
+    bool result = true;
+
+    printf("  \"perft\": [\n");
+    for (size_t i = 0; i < ARRLEN(g_positions); i++) {
+        const BenchPosition* position = &g_positions[i];
+        board_set_fen(board, position->fen);
+
+        const int64_t start   = clock_now_ms();
+        const uint64_t nodes  = move_perft(board, position->depth);
+        const int64_t elapsed = clock_now_ms() - start;
+
+        const bool matches = (nodes == position->expected);
+        if (!matches) {
+            fprintf(stderr,
+                    "Perft mismatch in '%s' at depth %d: %llu, expected %llu\n",
+                    position->name,
+                    position->depth,
+                    (unsigned long long)nodes,
+                    (unsigned long long)position->expected);
+            result = false;
+        }
+        *signature += nodes;
+
+        printf("    { \"name\": \"%s\", \"depth\": %d, \"nodes\": %llu, "
+               "\"ok\": %s, \"ms\": %lld, \"nps\": %.0f }%s\n",
+               position->name,
+               position->depth,
+               (unsigned long long)nodes,
+               matches ? "true" : "false",
+               (long long)elapsed,
+               per_second(nodes, elapsed),
+               (i + 1 < ARRLEN(g_positions)) ? "," : "");
+    }
+    printf("  ],\n");
+
+    return result;
+}
+
+/*
+ * Run the FEN benchmark, parsing and generating the FEN strings of each
+ * position, and printing a JSON object with the results.
+ *
+ * Returns true if all generated strings matched the parsed ones.
+ */
+static bool bench_fen(Board* board) {
+    char fen[BOARD_FEN_MAX];
+    bool result = true;
+
+    const int64_t start = clock_now_ms();
+    for (int i = 0; i < FEN_ITERATIONS; i++) {
+        const BenchPosition* position = &g_positions[i % ARRLEN(g_positions)];
+        result = result && board_set_fen(board, position->fen) &&
+                 board_get_fen(board, fen, sizeof(fen)) &&
+                 strcmp(fen, position->fen) == 0;
+    }
+    const int64_t elapsed = clock_now_ms() - start;
+
+    if (!result)
+        fprintf(stderr, "FEN round-trip mismatch.\n");
+
+    printf("  \"fen\": { \"iterations\": %d, \"ok\": %s, \"ms\": %lld, "
+           "\"per_second\": %.0f },\n",
+           FEN_ITERATIONS,
+           result ? "true" : "false",
+           (long long)elapsed,
+           per_second(FEN_ITERATIONS, elapsed));
+
+    return result;
+}
+
+/*
+ * Run the rendering benchmark, rendering each position to "/dev/null", and
+ * printing a JSON object with the results.
+ *
+ * If the headless renderer can't be started, the benchmark is skipped, and
+ * this function still returns true.
+ */
+static bool bench_render(Board* board) {
+    FILE* output = fopen("/dev/null", "w");
+    if (output == NULL || !render_startup_headless(output)) {
+        fprintf(stderr, "Failed to start headless renderer, skipping.\n");
+        printf("  \"render\": null,\n");
+        if (output != NULL)
+            fclose(output);
+        return true;
+    }
+
+    bool result = true;
+
+    const int64_t start = clock_now_ms();
+    for (int i = 0; result && i < RENDER_ITERATIONS; i++) {
+        const BenchPosition* position = &g_positions[i % ARRLEN(g_positions)];
+        result = board_set_fen(board, position->fen) &&
+                 render_board(board, NULL);
+    }
+    const int64_t elapsed = clock_now_ms() - start;
+
+    render_cleanup();
+    fclose(output);
+
+    if (!result)
+        fprintf(stderr, "Failed to render board.\n");
+
+    printf("  \"render\": { \"frames\": %d, \"ok\": %s, \"ms\": %lld, "
+           "\"fps\": %.0f },\n",
+           RENDER_ITERATIONS,
+           result ? "true" : "false",
+           (long long)elapsed,
+           per_second(RENDER_ITERATIONS, elapsed));
+
+    return result;
+}
+
+/*
+ * Run the search benchmark, searching each position with multiple lines up to
+ * a fixed depth, and printing a JSON array with the results. The total number
+ * of nodes is added to 'signature', so changes in the search or in the move
+ * ordering change it.
+ *
+ * Returns true if all searches found the expected number of lines.
+ */
+static bool bench_search(Board* board, uint64_t* signature) {
+    bool result = true;
+
+    Search search;
+    SearchResult search_result = { 0 };
+
+    printf("  \"search\": [\n");
+    for (size_t i = 0; i < ARRLEN(g_positions); i++) {
+        const BenchPosition* position = &g_positions[i];
+
+        board_set_fen(board, position->fen);
+        if (!search_init(&search, board, SEARCH_LINES)) {
+            fprintf(stderr,
+                    "Failed to start search of '%s'.\n",
+                    position->name);
+            printf("    null%s\n", (i + 1 < ARRLEN(g_positions)) ? "," : "");
+            result = false;
+            continue;
+        }
+
+        const int64_t start  = clock_now_ms();
+        const bool completed = search_run(&search,
+                                          NULL,
+                                          SEARCH_DEPTH,
+                                          &search_result,
+                                          NULL,
+                                          NULL);
+        const int64_t elapsed = clock_now_ms() - start;
+
+        const bool matches = completed &&
+                             search_result.depth == SEARCH_DEPTH &&
+                             search_result.num_lines == SEARCH_LINES;
+        if (!matches) {
+            fprintf(stderr, "Search of '%s' failed.\n", position->name);
+            result = false;
+        }
+
+        printf("    { \"name\": \"%s\", \"depth\": %d, \"nodes\": %llu, "
+               "\"ok\": %s, \"ms\": %lld, \"nps\": %.0f }%s\n",
+               position->name,
+               SEARCH_DEPTH,
+               (unsigned long long)search.nodes,
+               matches ? "true" : "false",
+               (long long)elapsed,
+               per_second(search.nodes, elapsed),
+               (i + 1 < ARRLEN(g_positions)) ? "," : "");
+        *signature += search.nodes;
+
+        search_destroy(&search);
+    }
+    printf("  ],\n");
+
+    return result;
+}
+
+/*
+ * Run a search of the second position with a fixed time and no depth limit,
+ * printing a JSON object with the results. The node counts of this benchmark
+ * depend on the speed of the machine, so they are not part of the signature.
+ *
+ * Fixed-time searches use their whole time, so this checks that the search is
+ * aborted in the middle of an iteration, by the periodic checks of the hard
+ * deadline.
+ *
+ * Returns true if the search completed at least one iteration, and if it
+ * stopped before 'TIMED_SEARCH_MAX_FACTOR' times its hard deadline. The time
+ * spent after the hard deadline is reported as "overrun_ms".
+ */
+static bool bench_timed_search(Board* board) {
+    Search search;
+    SearchResult search_result = { 0 };
+    TimeManager timeman;
+
+    if (!board_set_fen(board, g_positions[1].fen) ||
+        !search_init(&search, board, 1)) {
+        fprintf(stderr, "Failed to start the timed search.\n");
+        printf("  \"timed_search\": null,\n");
+        return false;
+    }
+
+    timeman_init_fixed(&timeman, TIMED_SEARCH_MS);
+    const bool completed = search_run(&search,
+                                      &timeman,
+                                      SEARCH_MAX_PLY,
+                                      &search_result,
+                                      NULL,
+                                      NULL);
+    const int64_t elapsed = timeman_elapsed_ms(&timeman);
+
+    const int64_t overrun =
+      (elapsed > timeman.hard_ms) ? elapsed - timeman.hard_ms : 0;
+    const bool in_time =
+      (elapsed <= timeman.hard_ms * TIMED_SEARCH_MAX_FACTOR);
+    if (!completed || !in_time)
+        fprintf(stderr,
+                "Timed search failed: %lld ms, deadline %lld ms.\n",
+                (long long)elapsed,
+                (long long)timeman.hard_ms);
+
+    printf("  \"timed_search\": { \"limit_ms\": %d, \"depth\": %d, "
+           "\"nodes\": %llu, \"ok\": %s, \"ms\": %lld, \"overrun_ms\": %lld, "
+           "\"nps\": %.0f },\n",
+           TIMED_SEARCH_MS,
+           completed ? search_result.depth : 0,
+           (unsigned long long)search.nodes,
+           (completed && in_time) ? "true" : "false",
+           (long long)elapsed,
+           (long long)overrun,
+           per_second(search.nodes, elapsed));
+
+    search_destroy(&search);
+    return completed && in_time;
+}
+
+/*
+ * Run a search limited by the time manager of a game clock, printing a JSON
+ * object with the results. Like the timed search, it's not part of the
+ * signature.
+ *
+ * Returns true if the search found the expected move, and if it stopped
+ * because the best move was stable, before the soft deadline of the clock.
+ */
+static bool bench_clock_search(Board* board) {
+    Search search;
+    SearchResult search_result = { 0 };
+    TimeManager timeman;
+    GameClock clock;
+
+    if (!board_set_fen(board, CLOCK_SEARCH_FEN) ||
+        !search_init(&search, board, 1)) {
+        fprintf(stderr, "Failed to start the clock search.\n");
+        printf("  \"clock_search\": null,\n");
+        return false;
+    }
+
+    clock_init(&clock, CLOCK_SEARCH_BASE_MS, 0, 0);
+    clock_start(&clock, board->turn);
+    timeman_init(&timeman, &clock, board->turn);
+    const bool completed = search_run(&search,
+                                      &timeman,
+                                      SEARCH_MAX_PLY,
+                                      &search_result,
+                                      NULL,
+                                      NULL);
+    const int64_t elapsed = timeman_elapsed_ms(&timeman);
+
+    char best[MOVE_STR_MAX] = "-";
+    if (completed && search_result.num_lines > 0)
+        move_to_str(&search_result.lines[0].moves[0], best);
+
+    const bool is_stable = !timeman.stopped && elapsed < timeman.soft_ms &&
+                           timeman.stability >= TIMEMAN_STABLE_ITERATIONS;
+    const bool ok = is_stable && strcmp(best, CLOCK_SEARCH_BEST) == 0;
+    if (!ok)
+        fprintf(stderr,
+                "Clock search failed: %s in %lld ms, soft deadline %lld ms.\n",
+                best,
+                (long long)elapsed,
+                (long long)timeman.soft_ms);
+
+    printf("  \"clock_search\": { \"soft_ms\": %lld, \"depth\": %d, "
+           "\"nodes\": %llu, \"best\": \"%s\", \"ok\": %s, \"ms\": %lld },\n",
+           (long long)timeman.soft_ms,
+           completed ? search_result.depth : 0,
+           (unsigned long long)search.nodes,
+           best,
+           ok ? "true" : "false",
+           (long long)elapsed);
+
+    search_destroy(&search);
+    return ok;
+}
+
+/*----------------------------------------------------------------------------*/
+
+int main(void) {
+    const size_t board_width  = 8;
+    const size_t board_height = 8;
+
+    Board board;
+    if (!board_init(&board, board_width, board_height)) {
+        fprintf(stderr,
+                "Failed to initialize %zux%zu board.\n",
+                board_width,
+                board_height);
+        return 1;
+    }
+
+    if (!validate_positions(&board)) {
+        printf("{ \"ok\": false }\n");
+        board_destroy(&board);
+        return 1;
+    }
+
+    uint64_t signature = 0;
+    bool result        = true;
+
+    printf("{\n");
+    result = bench_perft(&board, &signature) && result;
+    result = bench_search(&board, &signature) && result;
+    result = bench_timed_search(&board) && result;
+    result = bench_clock_search(&board) && result;
+    result = bench_fen(&board) && result;
+    result = bench_render(&board) && result;
+    printf("  \"signature\": %llu,\n", (unsigned long long)signature);
+    printf("  \"ok\": %s\n", result ? "true" : "false");
+    printf("}\n");
+
+    board_destroy(&board);
+    return result ? 0 : 1;
+}
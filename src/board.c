@@ -17,11 +17,21 @@
  */
 
 #include <assert.h>
+#include <ctype.h>
+#include <limits.h>
+#include <stdarg.h>
 #include <stdbool.h>
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include "include/board.h"
+#include "include/eval.h"
+#include "include/hash.h"
+#include "include/move.h"
 #include "include/piece.h"
+#include "include/profile.h"
+#include "include/util.h"
 
 static void set_board_cell(Board* board, size_t x, size_t y,
                            enum EPieceType type, enum EPieceColor color) {
@@ -32,6 +42,172 @@ static void set_board_cell(Board* board, size_t x, size_t y,
     cell->piece.color     = color;
 }
 
+/*
+ * Remove all pieces from the board, and reset its state to the one of a new
+ * game, without castling rights.
+ */
+static void clear_board(Board* board) {
+    for (int y = 0; y < board->height; y++)
+        for (int x = 0; x < board->width; x++)
+            board_cell_at(board, (BoardCoordinate){ x, y })->has_piece = false;
+
+    board->turn            = PIECE_COL_WHITE;
+    board->castling        = BOARD_CASTLE_NONE;
+    board->en_passant.x    = BOARD_COL_NONE;
+    board->en_passant.y    = BOARD_ROW_NONE;
+    board->halfmove_clock  = 0;
+    board->fullmove_number = 1;
+    board->hash            = board_compute_hash(board);
+    board->en_passant_key  = 0;
+    board->eval            = board_compute_eval(board);
+
+    board->castling_rook_x[0] = board->width - 1;
+    board->castling_rook_x[1] = 0;
+    board->castling_rook_x[2] = board->width - 1;
+    board->castling_rook_x[3] = 0;
+}
+
+/*
+ * Return the column of the outermost rook of the specified color in the
+ * specified row, on the specified side of the column 'from', or -1 if there is
+ * none.
+ */
+static int find_outer_rook(const Board* board, int y, int from,
+                           enum EPieceColor color, bool king_side) {
+    const int step = king_side ? -1 : 1;
+
+    for (int x = king_side ? board->width - 1 : 0; x != from; x += step) {
+        const BoardCell* cell = board_cell_at(board, (BoardCoordinate){ x, y });
+        if (cell->has_piece && cell->piece.type == PIECE_TYPE_ROOK &&
+            cell->piece.color == color)
+            return x;
+    }
+
+    return -1;
+}
+
+/*
+ * Return the column of the king of the specified color in its first row, or -1
+ * if it's not there.
+ */
+static int find_castling_king(const Board* board, enum EPieceColor color) {
+    const int y = (color == PIECE_COL_WHITE) ? board->height - 1 : 0;
+
+    for (int x = 0; x < board->width; x++) {
+        const BoardCell* cell = board_cell_at(board, (BoardCoordinate){ x, y });
+        if (cell->has_piece && cell->piece.type == PIECE_TYPE_KING &&
+            cell->piece.color == color)
+            return x;
+    }
+
+    return -1;
+}
+
+/*
+ * Parse a single character of the castling rights of a FEN string, and add
+ * the right to the board. Besides the standard "KQkq" characters, the column
+ * of the rook can be specified with a letter, as in Shredder-FEN and X-FEN,
+ * which is needed in Chess960 when there is more than one rook on one side.
+ *
+ * Returns false if the character is not valid, or if the king or the rook are
+ * not in their first row.
+ */
+static bool parse_castling_char(Board* board, char c) {
+    const enum EPieceColor color =
+      isupper((unsigned char)c) ? PIECE_COL_WHITE : PIECE_COL_BLACK;
+    const int y      = (color == PIECE_COL_WHITE) ? board->height - 1 : 0;
+    const int king_x = find_castling_king(board, color);
+    if (king_x < 0)
+        return false;
+
+    int rook_x;
+    const char lower = tolower((unsigned char)c);
+    if (lower == 'k') {
+        rook_x = find_outer_rook(board, y, king_x, color, true);
+    } else if (lower == 'q') {
+        rook_x = find_outer_rook(board, y, king_x, color, false);
+    } else {
+        rook_x = lower - 'a';
+        if (rook_x < 0 || rook_x >= board->width)
+            return false;
+
+        const BoardCell* cell =
+          board_cell_at(board, (BoardCoordinate){ rook_x, y });
+        if (!cell->has_piece || cell->piece.type != PIECE_TYPE_ROOK ||
+            cell->piece.color != color)
+            return false;
+    }
+    if (rook_x < 0 || rook_x == king_x)
+        return false;
+
+    const enum EBoardCastling right =
+      board_castling_right(color, rook_x > king_x);
+    board->castling |= right;
+    board->castling_rook_x[board_castling_index(right)] = rook_x;
+    return true;
+}
+
+/*
+ * Get the character used for a single castling right in a FEN string. The
+ * standard "KQkq" characters are used unless there is another rook between the
+ * castling rook and the edge of the board.
+ */
+static char get_castling_char(const Board* board, enum EBoardCastling right) {
+    const bool is_white  = (right == BOARD_CASTLE_WHITE_KING ||
+                           right == BOARD_CASTLE_WHITE_QUEEN);
+    const bool king_side = (right == BOARD_CASTLE_WHITE_KING ||
+                            right == BOARD_CASTLE_BLACK_KING);
+    const enum EPieceColor color = is_white ? PIECE_COL_WHITE : PIECE_COL_BLACK;
+    const int y      = is_white ? board->height - 1 : 0;
+    const int rook_x = board->castling_rook_x[board_castling_index(right)];
+
+    char c;
+    if (find_outer_rook(board, y, rook_x, color, king_side) < 0)
+        c = king_side ? 'k' : 'q';
+    else
+        c = 'a' + rook_x;
+
+    return is_white ? toupper((unsigned char)c) : c;
+}
+
+/*
+ * Check if the en passant cell of the board is consistent with the rest of the
+ * position: it should be empty, in the row skipped by a double pawn push of the
+ * opponent, and that pawn should be in front of it.
+ */
+static bool is_valid_en_passant(const Board* board) {
+    const bool is_white = (board->turn == PIECE_COL_WHITE);
+    const int row       = is_white ? 2 : board->height - 3;
+    const int pawn_row  = is_white ? row + 1 : row - 1;
+
+    const BoardCoordinate pawn_coord = { board->en_passant.x, pawn_row };
+    const BoardCell* cell = board_cell_at(board, board->en_passant);
+    const BoardCell* pawn = board_cell_at(board, pawn_coord);
+
+    return board->en_passant.y == row && !cell->has_piece && pawn->has_piece &&
+           pawn->piece.type == PIECE_TYPE_PAWN &&
+           pawn->piece.color ==
+             (is_white ? PIECE_COL_BLACK : PIECE_COL_WHITE);
+}
+
+/*
+ * Append the specified formatted string to a buffer of the specified size, at
+ * the specified position, which is updated. Returns false if it didn't fit.
+ */
+static bool append_fmt(char* dst, size_t size, size_t* pos, const char* fmt,
+                       ...) {
+    va_list va;
+    va_start(va, fmt);
+    const int written = vsnprintf(dst + *pos, size - *pos, fmt, va);
+    va_end(va);
+
+    if (written < 0 || (size_t)written >= size - *pos)
+        return false;
+
+    *pos += written;
+    return true;
+}
+
 /*----------------------------------------------------------------------------*/
 
 bool board_init(Board* board, size_t width, size_t height) {
@@ -41,15 +217,17 @@ bool board_init(Board* board, size_t width, size_t height) {
     board->selection.y = BOARD_ROW_NONE;
     board->width       = width;
     board->height      = height;
+    board->variant     = VARIANT_STANDARD;
+
+    if (board->width * board->height > HASH_MAX_CELLS)
+        return false;
+    hash_init();
 
     board->cells = malloc(board->width * board->height * sizeof(BoardCell));
     if (board->cells == NULL)
         return false;
 
-    for (int y = 0; y < board->height; y++)
-        for (int x = 0; x < board->width; x++)
-            board_cell_at(board, (BoardCoordinate){ x, y })->has_piece = false;
-
+    clear_board(board);
     return true;
 }
 
@@ -60,39 +238,331 @@ void board_destroy(Board* board) {
     }
 }
 
+void board_copy_position(Board* dst, const Board* src) {
+    assert(dst->width == src->width && dst->height == src->height);
+
+    const size_t num_cells = src->width * src->height;
+    memcpy(dst->cells, src->cells, num_cells * sizeof(BoardCell));
+    dst->turn            = src->turn;
+    dst->castling        = src->castling;
+    dst->en_passant      = src->en_passant;
+    dst->halfmove_clock  = src->halfmove_clock;
+    dst->fullmove_number = src->fullmove_number;
+    dst->hash            = src->hash;
+    dst->en_passant_key  = src->en_passant_key;
+    dst->eval            = src->eval;
+    dst->variant         = src->variant;
+    memcpy(dst->castling_rook_x,
+           src->castling_rook_x,
+           sizeof(dst->castling_rook_x));
+}
+
 bool board_set_initial_layout(Board* board) {
+    return board_set_chess960_layout(board, BOARD_CHESS960_STANDARD);
+}
+
+bool board_set_chess960_layout(Board* board, int index) {
     /* TODO: Support arbitrary board dimensions */
     assert(board->width == 8 && board->height == 8);
 
-    int y;
-
-    /* Black pieces, top of the board */
-    y = BOARD_ROW_8;
-    set_board_cell(board, BOARD_COL_A, y, PIECE_TYPE_ROOK, PIECE_COL_BLACK);
-    set_board_cell(board, BOARD_COL_B, y, PIECE_TYPE_KNIGHT, PIECE_COL_BLACK);
-    set_board_cell(board, BOARD_COL_C, y, PIECE_TYPE_BISHOP, PIECE_COL_BLACK);
-    set_board_cell(board, BOARD_COL_D, y, PIECE_TYPE_QUEEN, PIECE_COL_BLACK);
-    set_board_cell(board, BOARD_COL_E, y, PIECE_TYPE_KING, PIECE_COL_BLACK);
-    set_board_cell(board, BOARD_COL_F, y, PIECE_TYPE_BISHOP, PIECE_COL_BLACK);
-    set_board_cell(board, BOARD_COL_G, y, PIECE_TYPE_KNIGHT, PIECE_COL_BLACK);
-    set_board_cell(board, BOARD_COL_H, y, PIECE_TYPE_ROOK, PIECE_COL_BLACK);
-    y = BOARD_ROW_7;
-    for (int x = 0; x < board->width; x++)
-        set_board_cell(board, x, y, PIECE_TYPE_PAWN, PIECE_COL_BLACK);
-
-    /* White pieces, bottom of the board */
-    y = BOARD_ROW_1;
-    set_board_cell(board, BOARD_COL_A, y, PIECE_TYPE_ROOK, PIECE_COL_WHITE);
-    set_board_cell(board, BOARD_COL_B, y, PIECE_TYPE_KNIGHT, PIECE_COL_WHITE);
-    set_board_cell(board, BOARD_COL_C, y, PIECE_TYPE_BISHOP, PIECE_COL_WHITE);
-    set_board_cell(board, BOARD_COL_D, y, PIECE_TYPE_QUEEN, PIECE_COL_WHITE);
-    set_board_cell(board, BOARD_COL_E, y, PIECE_TYPE_KING, PIECE_COL_WHITE);
-    set_board_cell(board, BOARD_COL_F, y, PIECE_TYPE_BISHOP, PIECE_COL_WHITE);
-    set_board_cell(board, BOARD_COL_G, y, PIECE_TYPE_KNIGHT, PIECE_COL_WHITE);
-    set_board_cell(board, BOARD_COL_H, y, PIECE_TYPE_ROOK, PIECE_COL_WHITE);
-    y = BOARD_ROW_2;
-    for (int x = 0; x < board->width; x++)
-        set_board_cell(board, x, y, PIECE_TYPE_PAWN, PIECE_COL_WHITE);
+    if (index < 0 || index >= BOARD_CHESS960_COUNT)
+        return false;
+
+    /*
+     * Positions of the two knights in the five cells that are still empty
+     * after placing the bishops and the queen.
+     */
+    static const int knight_cells[10][2] = {
+        { 0, 1 }, { 0, 2 }, { 0, 3 }, { 0, 4 }, { 1, 2 },
+        { 1, 3 }, { 1, 4 }, { 2, 3 }, { 2, 4 }, { 3, 4 },
+    };
+
+    enum EPieceType row[8] = { PIECE_TYPE_UNKNOWN };
+    int n                  = index;
+
+    /* Bishops on cells of different colors */
+    row[(n % 4) * 2 + 1] = PIECE_TYPE_BISHOP;
+    n /= 4;
+    row[(n % 4) * 2] = PIECE_TYPE_BISHOP;
+    n /= 4;
+
+    /* The queen and the knights, counting only the empty cells */
+    int queen_cell         = n % 6;
+    const int* knight_pair = knight_cells[n / 6];
+    for (int x = 0; x < 8; x++) {
+        if (row[x] != PIECE_TYPE_UNKNOWN)
+            continue;
+        if (queen_cell-- == 0)
+            row[x] = PIECE_TYPE_QUEEN;
+    }
+    for (int x = 0, empty = 0; x < 8; x++) {
+        if (row[x] != PIECE_TYPE_UNKNOWN)
+            continue;
+        if (empty == knight_pair[0] || empty == knight_pair[1])
+            row[x] = PIECE_TYPE_KNIGHT;
+        empty++;
+    }
+
+    /* The king between the two rooks, in the remaining three cells */
+    const enum EPieceType rest[] = {
+        PIECE_TYPE_ROOK,
+        PIECE_TYPE_KING,
+        PIECE_TYPE_ROOK,
+    };
+    int rest_x[ARRLEN(rest)];
+    int num_rest = 0;
+    for (int x = 0; x < 8; x++) {
+        if (row[x] == PIECE_TYPE_UNKNOWN) {
+            rest_x[num_rest] = x;
+            row[x]           = rest[num_rest++];
+        }
+    }
 
+    clear_board(board);
+    board->castling = BOARD_CASTLE_ALL;
+    for (int i = 0; i < 4; i++) {
+        const bool king_side = (i % 2 == 0);
+        board->castling_rook_x[i] = king_side ? rest_x[2] : rest_x[0];
+    }
+
+    for (int x = 0; x < board->width; x++) {
+        set_board_cell(board, x, BOARD_ROW_8, row[x], PIECE_COL_BLACK);
+        set_board_cell(board, x, BOARD_ROW_7, PIECE_TYPE_PAWN, PIECE_COL_BLACK);
+        set_board_cell(board, x, BOARD_ROW_2, PIECE_TYPE_PAWN, PIECE_COL_WHITE);
+        set_board_cell(board, x, BOARD_ROW_1, row[x], PIECE_COL_WHITE);
+    }
+
+    board->hash           = board_compute_hash(board);
+    board->en_passant_key = 0;
+    board->eval           = board_compute_eval(board);
     return true;
 }
+
+bool board_set_fen(Board* board, const char* fen) {
+    clear_board(board);
+
+    /* Piece placement, from the top row */
+    int x = 0, y = 0;
+    for (; *fen != '\0' && *fen != ' '; fen++) {
+        if (*fen == '/') {
+            if (x != board->width || ++y >= board->height)
+                return false;
+            x = 0;
+        } else if (isdigit((unsigned char)*fen)) {
+            char* endptr;
+            const long empty_cells = strtol(fen, &endptr, 10);
+            if (empty_cells < 1 || empty_cells > board->width - x)
+                return false;
+            x += empty_cells;
+            fen = endptr - 1;
+        } else {
+            Piece piece;
+            if (x >= board->width || !piece_from_fen_char(*fen, &piece))
+                return false;
+            set_board_cell(board, x++, y, piece.type, piece.color);
+        }
+    }
+    if (x != board->width || y != board->height - 1 || *fen++ != ' ')
+        return false;
+
+    /* Active color */
+    switch (*fen++) {
+        case 'w':
+            board->turn = PIECE_COL_WHITE;
+            break;
+        case 'b':
+            board->turn = PIECE_COL_BLACK;
+            break;
+        default:
+            return false;
+    }
+    if (*fen++ != ' ')
+        return false;
+
+    /* Castling rights */
+    if (*fen == '-') {
+        fen++;
+    } else {
+        for (; *fen != '\0' && *fen != ' '; fen++)
+            if (!parse_castling_char(board, *fen))
+                return false;
+    }
+    if (*fen++ != ' ')
+        return false;
+
+    /* En passant target cell */
+    if (*fen == '-') {
+        fen++;
+    } else {
+        char* endptr;
+        const int col = *fen - 'a';
+        const long row = strtol(fen + 1, &endptr, 10);
+        if (col < 0 || col >= board->width || row < 1 || row > board->height)
+            return false;
+        board->en_passant.x = col;
+        board->en_passant.y = board->height - row;
+        fen                 = endptr;
+
+        /*
+         * The cell should be empty, and the pawn that was just pushed should
+         * be in front of it. Otherwise, the en passant captures would remove
+         * a different piece.
+         */
+        if (!is_valid_en_passant(board))
+            return false;
+    }
+
+    board->hash           = board_compute_hash(board);
+    board->en_passant_key = board_en_passant_key(board);
+    board->eval           = board_compute_eval(board);
+
+    /* The move counters are optional */
+    if (*fen == '\0')
+        return true;
+
+    char* endptr;
+    const long halfmove_clock = strtol(fen, &endptr, 10);
+    if (endptr == fen || halfmove_clock < 0 || halfmove_clock > INT_MAX)
+        return false;
+    board->halfmove_clock = halfmove_clock;
+    fen                   = endptr;
+
+    const long fullmove_number = strtol(fen, &endptr, 10);
+    if (endptr == fen || fullmove_number < 1 || fullmove_number > INT_MAX)
+        return false;
+    board->fullmove_number = fullmove_number;
+    fen                    = endptr;
+
+    return *fen == '\0';
+}
+
+bool board_get_fen(const Board* board, char* dst, size_t size) {
+    size_t pos = 0;
+
+    if (size == 0)
+        return false;
+    dst[0] = '\0';
+
+    /* Piece placement, from the top row */
+    for (int y = 0; y < board->height; y++) {
+        int empty = 0;
+        for (int x = 0; x < board->width; x++) {
+            const BoardCell* cell =
+              board_cell_at(board, (BoardCoordinate){ x, y });
+            if (!cell->has_piece) {
+                empty++;
+                continue;
+            }
+
+            if (empty > 0 && !append_fmt(dst, size, &pos, "%d", empty))
+                return false;
+            empty = 0;
+
+            if (!append_fmt(dst,
+                            size,
+                            &pos,
+                            "%c",
+                            piece_get_fen_char(&cell->piece)))
+                return false;
+        }
+
+        if (empty > 0 && !append_fmt(dst, size, &pos, "%d", empty))
+            return false;
+        if (y < board->height - 1 && !append_fmt(dst, size, &pos, "/"))
+            return false;
+    }
+
+    /* Active color and castling rights */
+    if (!append_fmt(dst,
+                    size,
+                    &pos,
+                    " %c ",
+                    (board->turn == PIECE_COL_WHITE) ? 'w' : 'b'))
+        return false;
+
+    static const enum EBoardCastling rights[] = {
+        BOARD_CASTLE_WHITE_KING,
+        BOARD_CASTLE_WHITE_QUEEN,
+        BOARD_CASTLE_BLACK_KING,
+        BOARD_CASTLE_BLACK_QUEEN,
+    };
+    for (size_t i = 0; i < ARRLEN(rights); i++)
+        if ((board->castling & rights[i]) &&
+            !append_fmt(dst,
+                        size,
+                        &pos,
+                        "%c",
+                        get_castling_char(board, rights[i])))
+            return false;
+
+    if (!append_fmt(dst,
+                    size,
+                    &pos,
+                    "%s ",
+                    (board->castling == BOARD_CASTLE_NONE) ? "-" : ""))
+        return false;
+
+    /* En passant target cell */
+    if (board->en_passant.x == BOARD_COL_NONE) {
+        if (!append_fmt(dst, size, &pos, "-"))
+            return false;
+    } else if (!append_fmt(dst,
+                           size,
+                           &pos,
+                           "%c%d",
+                           'a' + board->en_passant.x,
+                           board->height - board->en_passant.y)) {
+        return false;
+    }
+
+    return append_fmt(dst,
+                      size,
+                      &pos,
+                      " %d %d",
+                      board->halfmove_clock,
+                      board->fullmove_number);
+}
+
+uint64_t board_en_passant_key(const Board* board) {
+    return move_can_capture_en_passant(board)
+             ? hash_en_passant(board->en_passant.x)
+             : 0;
+}
+
+uint64_t board_compute_hash(const Board* board) {
+    uint64_t result = 0;
+
+    for (int y = 0; y < board->height; y++) {
+        for (int x = 0; x < board->width; x++) {
+            const BoardCell* cell =
+              board_cell_at(board, (BoardCoordinate){ x, y });
+            if (cell->has_piece)
+                result ^= hash_piece(&cell->piece, board->width * y + x);
+        }
+    }
+
+    result ^= hash_castling(board->castling);
+    result ^= board_en_passant_key(board);
+    if (board->turn == PIECE_COL_BLACK)
+        result ^= hash_black_turn();
+
+    return result;
+}
+
+int board_compute_eval(const Board* board) {
+    PROFILE_BEGIN(PROFILE_SPAN_EVAL);
+
+    int result = 0;
+
+    for (int y = 0; y < board->height; y++) {
+        for (int x = 0; x < board->width; x++) {
+            const BoardCell* cell =
+              board_cell_at(board, (BoardCoordinate){ x, y });
+            if (cell->has_piece)
+                result += eval_piece(board, &cell->piece, x, y);
+        }
+    }
+
+    PROFILE_END(PROFILE_SPAN_EVAL);
+    return result;
+}
@@ -0,0 +1,174 @@
+/*
+ * Copyright 2025 8dcc
+ *
+ * This file is part of 8dcc's Chess.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#define _POSIX_C_SOURCE 199309L /* clock_gettime */
+
+#include <limits.h>
+#include <math.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <time.h>
+
+#include "include/clock.h"
+#include "include/piece.h"
+
+/*
+ * Maximum base time and increment accepted by 'clock_init_from_str', in
+ * milliseconds. It's exactly representable as a double, and far enough from
+ * 'INT64_MAX' for adding it to the remaining time many times without
+ * overflowing.
+ */
+#define MAX_TIME_MS ((int64_t)1 << 52)
+
+/*
+ * Return the index in the 'GameClock' arrays for the specified color.
+ */
+static inline int clock_color_index(enum EPieceColor color) {
+    return (color == PIECE_COL_WHITE) ? 0 : 1;
+}
+
+/*
+ * Return the opposite of the specified color.
+ */
+static inline enum EPieceColor opposite_color(enum EPieceColor color) {
+    return (color == PIECE_COL_WHITE) ? PIECE_COL_BLACK : PIECE_COL_WHITE;
+}
+
+/*----------------------------------------------------------------------------*/
+
+int64_t clock_now_ms(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (int64_t)ts.tv_sec * 1000 + ts.tv_nsec / 1000000;
+}
+
+void clock_init(GameClock* clock, int64_t base_ms, int64_t increment_ms,
+                int moves_to_go) {
+    clock->base_ms      = base_ms;
+    clock->increment_ms = increment_ms;
+    clock->moves_to_go  = moves_to_go;
+
+    for (int i = 0; i < 2; i++) {
+        clock->remaining_ms[i] = base_ms;
+        clock->moves_left[i]   = moves_to_go;
+    }
+
+    clock->running    = PIECE_COL_UNKNOWN;
+    clock->started_ms = 0;
+}
+
+/*
+ * Parse a non-negative time from the start of 'str', in the unit of the
+ * specified number of milliseconds, storing it in milliseconds in 'dst', and
+ * the end of the number in 'endptr'.
+ *
+ * This function returns false if there is no number, or if it's not finite,
+ * negative, or greater than 'MAX_TIME_MS' when converted.
+ */
+static bool parse_time(const char* str, double unit_ms, char** endptr,
+                       int64_t* dst) {
+    const double value = strtod(str, endptr);
+    if (*endptr == str || !isfinite(value) || value < 0)
+        return false;
+
+    const double ms = value * unit_ms;
+    if (ms > (double)MAX_TIME_MS)
+        return false;
+
+    *dst = (int64_t)ms;
+    return true;
+}
+
+bool clock_init_from_str(GameClock* clock, const char* str) {
+    char* endptr;
+
+    int64_t base_ms;
+    if (!parse_time(str, 60 * 1000, &endptr, &base_ms) || base_ms <= 0)
+        return false;
+    str = endptr;
+
+    int64_t increment_ms = 0;
+    if (*str == '+') {
+        str++;
+        if (!parse_time(str, 1000, &endptr, &increment_ms))
+            return false;
+        str = endptr;
+    }
+
+    long moves_to_go = 0;
+    if (*str == '/') {
+        str++;
+        moves_to_go = strtol(str, &endptr, 10);
+        if (endptr == str || moves_to_go <= 0 || moves_to_go > INT_MAX)
+            return false;
+        str = endptr;
+    }
+
+    if (*str != '\0')
+        return false;
+
+    clock_init(clock, base_ms, increment_ms, (int)moves_to_go);
+    return true;
+}
+
+void clock_start(GameClock* clock, enum EPieceColor color) {
+    const int64_t now = clock_now_ms();
+
+    /* Stop the running clock, without any increment */
+    if (clock->running != PIECE_COL_UNKNOWN)
+        clock->remaining_ms[clock_color_index(clock->running)] -=
+          now - clock->started_ms;
+
+    clock->running    = color;
+    clock->started_ms = now;
+}
+
+void clock_press(GameClock* clock) {
+    if (clock->running == PIECE_COL_UNKNOWN ||
+        clock_is_flagged(clock, clock->running))
+        return;
+
+    const int64_t now = clock_now_ms();
+    const int i       = clock_color_index(clock->running);
+
+    clock->remaining_ms[i] -= now - clock->started_ms;
+    clock->remaining_ms[i] += clock->increment_ms;
+
+    /* Completed a time control period, add the base time again */
+    if (clock->moves_to_go > 0 && --clock->moves_left[i] <= 0) {
+        clock->remaining_ms[i] += clock->base_ms;
+        clock->moves_left[i] = clock->moves_to_go;
+    }
+
+    clock->running    = opposite_color(clock->running);
+    clock->started_ms = now;
+}
+
+int64_t clock_remaining_ms(const GameClock* clock, enum EPieceColor color) {
+    int64_t result = clock->remaining_ms[clock_color_index(color)];
+
+    if (clock->running == color)
+        result -= clock_now_ms() - clock->started_ms;
+
+    return (result < 0) ? 0 : result;
+}
+
+int clock_moves_left(const GameClock* clock, enum EPieceColor color) {
+    return clock->moves_left[clock_color_index(color)];
+}
@@ -0,0 +1,54 @@
+/*
+ * Copyright 2025 8dcc
+ *
+ * This file is part of 8dcc's Chess.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include "include/eval.h"
+#include "include/piece.h"
+
+/*
+ * The king is not counted as material, since both players always have one. It
+ * has a negative centralization weight, since it's safer near the edges.
+ */
+const int g_eval_material[7] = {
+    [PIECE_TYPE_UNKNOWN] = 0,
+    [PIECE_TYPE_PAWN]    = 100,
+    [PIECE_TYPE_ROOK]    = 500,
+    [PIECE_TYPE_KNIGHT]  = 320,
+    [PIECE_TYPE_BISHOP]  = 330,
+    [PIECE_TYPE_QUEEN]   = 900,
+    [PIECE_TYPE_KING]    = 0,
+};
+
+const int g_eval_centralization[7] = {
+    [PIECE_TYPE_UNKNOWN] = 0,
+    [PIECE_TYPE_PAWN]    = 2,
+    [PIECE_TYPE_ROOK]    = 1,
+    [PIECE_TYPE_KNIGHT]  = 8,
+    [PIECE_TYPE_BISHOP]  = 4,
+    [PIECE_TYPE_QUEEN]   = 2,
+    [PIECE_TYPE_KING]    = -6,
+};
+
+const int g_eval_advancement[7] = {
+    [PIECE_TYPE_UNKNOWN] = 0,
+    [PIECE_TYPE_PAWN]    = 8,
+    [PIECE_TYPE_ROOK]    = 0,
+    [PIECE_TYPE_KNIGHT]  = 0,
+    [PIECE_TYPE_BISHOP]  = 0,
+    [PIECE_TYPE_QUEEN]   = 0,
+    [PIECE_TYPE_KING]    = 0,
+};
@@ -0,0 +1,483 @@
+/*
+ * Copyright 2025 8dcc
+ *
+ * This file is part of 8dcc's Chess.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Fuzzing harness for the FEN parser and the move code. Each input is a FEN
+ * string, optionally followed by a newline and a sequence of bytes, where each
+ * byte either makes one of the legal moves of the current position, or unmakes
+ * the last move (see 'UNMAKE_BYTE').
+ *
+ * After every step, the board is compared against a slow reference
+ * implementation that only uses the cells of the board (see 'reference_make'),
+ * and the incremental hash and evaluation are compared against a full
+ * recomputation. Any difference aborts the program, so it's reported by the
+ * fuzzer.
+ *
+ * When compiled with 'CHESS_FUZZ_LIBFUZZER', only 'LLVMFuzzerTestOneInput' is
+ * defined, for linking with libFuzzer. Otherwise, a 'main' function reads the
+ * inputs from files or from the standard input (e.g. for AFL), or generates
+ * random inputs with '--random'.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "include/board.h"
+#include "include/move.h"
+#include "include/util.h"
+
+/*
+ * Maximum length of the FEN string of an input, including the null
+ * terminator. Longer inputs are ignored.
+ */
+#define MAX_FEN_LEN 256
+
+/*
+ * Maximum number of moves that can be made by a single input.
+ */
+#define MAX_PLIES 512
+
+/*
+ * Bytes of the move sequence that are greater or equal to this value unmake
+ * the last move, instead of making a new one.
+ */
+#define UNMAKE_BYTE 0xF0
+
+/*
+ * Positions used as the base of the inputs generated with '--random'.
+ */
+static const char* g_random_fens[] = {
+    "rnbqkbnr/pppppppp/8/8/8/8/PPPPPPPP/RNBQKBNR w KQkq - 0 1",
+    "r3k2r/p1ppqpb1/bn2pnp1/3PN3/1p2P3/2N2Q1p/PPPBBPPP/R3K2R w KQkq - 0 1",
+    "8/2p5/3p4/KP5r/1R3p1k/8/4P1P1/8 w - - 0 1",
+    "r3k2r/Pppp1ppp/1b3nbN/nP6/BBP1P3/q4N2/Pp1P2PP/R2Q1RK1 w kq - 0 1",
+    "rnbq1k1r/pp1Pbppp/2p5/8/2B5/8/PPP1NnPP/RNBQK2R w KQ - 1 8",
+    "rnbqkbnr/ppp1p1pp/8/3pPp2/8/8/PPPP1PPP/RNBQKBNR w KQkq f6 0 3",
+    "bqnb1rkr/pp3ppp/3ppn2/2p5/5P2/P2P4/NPP1P1PP/BQ1BNRKR w HFhf - 2 9",
+    "1rqbkrbn/1ppppp1p/1n6/p1N3p1/8/2P4P/PP1PPPP1/1RQBKRBN w FBfb - 0 9",
+    "rk2r3/pppppppp/8/8/8/8/PPPPPPPP/RK2R3 w KQkq - 0 1",
+    "1k1r3r/8/8/8/8/8/8/1K1R3R w Dd - 0 1",
+};
+
+/*
+ * Characters used for mutating the FEN strings of the random inputs.
+ */
+static const char g_fen_alphabet[] =
+  "pnbrqkPNBRQK12345678/ wbKQkq-abcdefghABCDEFGH0";
+
+/*
+ * Boards used by the harness. They are initialized once, and reused across
+ * inputs. The history contains the position before each move, for checking
+ * 'move_unmake'.
+ */
+static bool g_initialized = false;
+static Board g_board;
+static Board g_reference;
+static Board g_fen_board;
+static Board g_history[MAX_PLIES];
+
+/*----------------------------------------------------------------------------*/
+
+/*
+ * Report a failed check with the specified message, and abort.
+ */
+static void fail(const char* message, const Board* board) {
+    char fen[BOARD_FEN_MAX];
+    if (!board_get_fen(board, fen, sizeof(fen)))
+        strcpy(fen, "(invalid)");
+
+    fprintf(stderr, "Fuzzing check failed: %s\nPosition: %s\n", message, fen);
+    abort();
+}
+
+/*
+ * Check if the cells and state of two boards are the same, ignoring the
+ * incremental members.
+ */
+static bool same_position(const Board* a, const Board* b) {
+    for (int y = 0; y < a->height; y++) {
+        for (int x = 0; x < a->width; x++) {
+            const BoardCoordinate coord = { .x = x, .y = y };
+            const BoardCell* cell_a     = board_cell_at(a, coord);
+            const BoardCell* cell_b     = board_cell_at(b, coord);
+            if (cell_a->has_piece != cell_b->has_piece)
+                return false;
+            if (cell_a->has_piece &&
+                (cell_a->piece.type != cell_b->piece.type ||
+                 cell_a->piece.color != cell_b->piece.color))
+                return false;
+        }
+    }
+
+    /* The rook columns are only meaningful for the current rights */
+    for (int i = 0; i < 4; i++)
+        if ((a->castling & (1 << i)) &&
+            a->castling_rook_x[i] != b->castling_rook_x[i])
+            return false;
+
+    return a->turn == b->turn && a->castling == b->castling &&
+           a->en_passant.x == b->en_passant.x &&
+           a->en_passant.y == b->en_passant.y &&
+           a->halfmove_clock == b->halfmove_clock &&
+           a->fullmove_number == b->fullmove_number;
+}
+
+/*
+ * Return the castling rights that are lost when a piece moves from or to the
+ * specified cell, because it's the cell of a castling rook. Written
+ * independently of the version in "move.c".
+ */
+static int reference_lost_rights(const Board* board, int x, int y) {
+    int result = BOARD_CASTLE_NONE;
+
+    for (int i = 0; i < 4; i++) {
+        const bool is_white = (i < 2);
+        if (y == (is_white ? board->height - 1 : 0) &&
+            x == board->castling_rook_x[i])
+            result |= 1 << i;
+    }
+
+    return result;
+}
+
+/*
+ * Slow reference implementation of 'move_make'. It only uses the source and
+ * destination cells of the move, and the cells of the board, instead of the
+ * flags of the move or any incremental state.
+ */
+static void reference_make(Board* board, const Move* move) {
+    BoardCell* src = board_cell_at(board, move->from);
+    BoardCell* dst = board_cell_at(board, move->to);
+
+    const bool is_pawn           = (src->piece.type == PIECE_TYPE_PAWN);
+    const bool is_king           = (src->piece.type == PIECE_TYPE_KING);
+    const enum EPieceColor color = src->piece.color;
+    bool is_capture              = dst->has_piece;
+
+    /* Capturing a king also loses its castling rights */
+    if (dst->has_piece && dst->piece.type == PIECE_TYPE_KING &&
+        dst->piece.color != color)
+        board->castling &= (dst->piece.color == PIECE_COL_WHITE)
+                             ? ~(BOARD_CASTLE_WHITE_KING |
+                                 BOARD_CASTLE_WHITE_QUEEN)
+                             : ~(BOARD_CASTLE_BLACK_KING |
+                                 BOARD_CASTLE_BLACK_QUEEN);
+
+    /* A pawn moving diagonally to an empty cell captures en passant */
+    if (is_pawn && move->from.x != move->to.x && !dst->has_piece) {
+        const BoardCoordinate captured = { .x = move->to.x, .y = move->from.y };
+        board_cell_at(board, captured)->has_piece = false;
+        is_capture                                = true;
+    }
+
+    /*
+     * A king moving to the cell of a rook of its color castles with it. Both
+     * pieces are lifted first, since the cells can overlap in Chess960.
+     */
+    if (is_king && dst->has_piece && dst->piece.color == color) {
+        const bool is_king_side = (move->to.x > move->from.x);
+        const BoardCell king    = *src;
+        const BoardCell rook    = *dst;
+        src->has_piece          = false;
+        dst->has_piece          = false;
+        is_capture              = false;
+
+        const BoardCoordinate king_dst = {
+            .x = is_king_side ? BOARD_COL_G : BOARD_COL_C,
+            .y = move->from.y,
+        };
+        const BoardCoordinate rook_dst = {
+            .x = is_king_side ? BOARD_COL_F : BOARD_COL_D,
+            .y = move->from.y,
+        };
+        *board_cell_at(board, king_dst) = king;
+        *board_cell_at(board, rook_dst) = rook;
+    } else {
+        *dst           = *src;
+        src->has_piece = false;
+    }
+
+    /* A pawn reaching the last row is promoted */
+    if (is_pawn && (move->to.y == 0 || move->to.y == board->height - 1))
+        dst->piece.type = move->promotion;
+
+    if (is_king)
+        board->castling &= (color == PIECE_COL_WHITE)
+                             ? ~(BOARD_CASTLE_WHITE_KING |
+                                 BOARD_CASTLE_WHITE_QUEEN)
+                             : ~(BOARD_CASTLE_BLACK_KING |
+                                 BOARD_CASTLE_BLACK_QUEEN);
+    board->castling &=
+      ~(reference_lost_rights(board, move->from.x, move->from.y) |
+        reference_lost_rights(board, move->to.x, move->to.y));
+
+    if (is_pawn && abs((int)move->to.y - (int)move->from.y) == 2) {
+        board->en_passant.x = move->from.x;
+        board->en_passant.y = (move->from.y + move->to.y) / 2;
+    } else {
+        board->en_passant.x = BOARD_COL_NONE;
+        board->en_passant.y = BOARD_ROW_NONE;
+    }
+
+    if (is_pawn || is_capture)
+        board->halfmove_clock = 0;
+    else
+        board->halfmove_clock++;
+
+    if (board->turn == PIECE_COL_BLACK)
+        board->fullmove_number++;
+    board->turn = (board->turn == PIECE_COL_WHITE) ? PIECE_COL_BLACK
+                                                   : PIECE_COL_WHITE;
+}
+
+/*
+ * Check the incremental members of the board against a full recomputation, its
+ * position against the reference board, and its FEN string against the one of
+ * the parsed position.
+ */
+static void check_board(const Board* board, const Board* reference) {
+    if (board->hash != board_compute_hash(board))
+        fail("incremental hash differs from full recomputation", board);
+
+    if (board->en_passant_key != board_en_passant_key(board))
+        fail("en passant key differs from full recomputation", board);
+
+    if (board->eval != board_compute_eval(board))
+        fail("incremental evaluation differs from full recomputation", board);
+
+    if (!same_position(board, reference))
+        fail("position differs from the reference implementation", board);
+
+    char fen[BOARD_FEN_MAX];
+    if (!board_get_fen(board, fen, sizeof(fen)) ||
+        !board_set_fen(&g_fen_board, fen) ||
+        !same_position(board, &g_fen_board) ||
+        board->hash != g_fen_board.hash || board->eval != g_fen_board.eval)
+        fail("FEN round-trip differs from the original position", board);
+}
+
+/*
+ * Initialize the boards of the harness, only once. Aborts on error.
+ */
+static void init_boards(void) {
+    if (g_initialized)
+        return;
+
+    bool result = board_init(&g_board, 8, 8) &&
+                  board_init(&g_reference, 8, 8) &&
+                  board_init(&g_fen_board, 8, 8);
+    for (size_t i = 0; result && i < MAX_PLIES; i++)
+        result = board_init(&g_history[i], 8, 8);
+
+    if (!result) {
+        fprintf(stderr, "Failed to initialize the fuzzing boards.\n");
+        abort();
+    }
+
+    g_initialized = true;
+}
+
+/*----------------------------------------------------------------------------*/
+
+int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size);
+
+int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+    init_boards();
+
+    /* The FEN string goes until the first newline, or the end of the input */
+    const uint8_t* newline = memchr(data, '\n', size);
+    const size_t fen_len = (newline != NULL) ? (size_t)(newline - data) : size;
+    if (fen_len >= MAX_FEN_LEN)
+        return 0;
+
+    char fen[MAX_FEN_LEN];
+    memcpy(fen, data, fen_len);
+    fen[fen_len] = '\0';
+
+    /* Invalid strings are expected, as long as they don't crash the parser */
+    if (!board_set_fen(&g_board, fen))
+        return 0;
+
+    board_copy_position(&g_reference, &g_board);
+    check_board(&g_board, &g_reference);
+
+    Move moves[MAX_PLIES];
+    MoveUndo undos[MAX_PLIES];
+    size_t num_plies = 0;
+
+    for (size_t i = fen_len + 1; i < size; i++) {
+        if (data[i] >= UNMAKE_BYTE) {
+            if (num_plies == 0)
+                continue;
+
+            num_plies--;
+            move_unmake(&g_board, &moves[num_plies], &undos[num_plies]);
+            board_copy_position(&g_reference, &g_history[num_plies]);
+            if (g_board.hash != g_history[num_plies].hash ||
+                g_board.eval != g_history[num_plies].eval)
+                fail("unmaking a move didn't restore the incremental state",
+                     &g_board);
+            check_board(&g_board, &g_reference);
+            continue;
+        }
+
+        if (num_plies >= MAX_PLIES)
+            break;
+
+        /* At the end of the game, only unmaking is possible */
+        MoveList list;
+        move_generate_legal(&g_board, &list);
+        if (list.count == 0)
+            continue;
+
+        const Move* move = &list.moves[data[i] % list.count];
+        board_copy_position(&g_history[num_plies], &g_board);
+        moves[num_plies] = *move;
+        move_make(&g_board, move, &undos[num_plies]);
+        num_plies++;
+
+        reference_make(&g_reference, move);
+        check_board(&g_board, &g_reference);
+    }
+
+    return 0;
+}
+
+/*----------------------------------------------------------------------------*/
+
+#ifndef CHESS_FUZZ_LIBFUZZER
+
+/*
+ * Read the whole contents of the specified file into an allocated buffer,
+ * storing its size. Returns NULL on error.
+ */
+static uint8_t* read_file(FILE* fp, size_t* size) {
+    size_t capacity = 4096;
+    uint8_t* data   = malloc(capacity);
+    *size           = 0;
+
+    while (data != NULL) {
+        *size += fread(data + *size, 1, capacity - *size, fp);
+        if (*size < capacity)
+            break;
+
+        capacity *= 2;
+        uint8_t* new_data = realloc(data, capacity);
+        if (new_data == NULL)
+            free(data);
+        data = new_data;
+    }
+
+    if (data != NULL && ferror(fp)) {
+        free(data);
+        return NULL;
+    }
+
+    return data;
+}
+
+/*
+ * Run the harness with the contents of the specified file, or of the standard
+ * input if the path is NULL. Returns false on error.
+ */
+static bool run_file(const char* path) {
+    FILE* fp = (path != NULL) ? fopen(path, "rb") : stdin;
+    if (fp == NULL) {
+        fprintf(stderr, "Failed to open '%s'.\n", path);
+        return false;
+    }
+
+    size_t size;
+    uint8_t* data = read_file(fp, &size);
+    if (path != NULL)
+        fclose(fp);
+    if (data == NULL)
+        return false;
+
+    LLVMFuzzerTestOneInput(data, size);
+    free(data);
+    return true;
+}
+
+/*
+ * Return the next number of a xorshift64 generator with the specified state.
+ */
+static uint64_t next_random(uint64_t* state) {
+    *state ^= *state << 13;
+    *state ^= *state >> 7;
+    *state ^= *state << 17;
+    return *state;
+}
+
+/*
+ * Run the harness with the specified number of random inputs, generated from
+ * the positions of 'g_random_fens'. Some FEN strings are mutated, for testing
+ * the parser, and the rest are followed by random move sequences.
+ */
+static void run_random(unsigned long count, uint64_t seed) {
+    uint64_t state = seed | 1;
+    uint8_t data[MAX_FEN_LEN + MAX_PLIES];
+
+    for (unsigned long i = 0; i < count; i++) {
+        const char* fen =
+          g_random_fens[next_random(&state) % ARRLEN(g_random_fens)];
+        size_t size = strlen(fen);
+        memcpy(data, fen, size);
+
+        if (next_random(&state) % 4 == 0) {
+            const int num_mutations = 1 + next_random(&state) % 3;
+            for (int j = 0; j < num_mutations; j++)
+                data[next_random(&state) % size] =
+                  g_fen_alphabet[next_random(&state) %
+                                 STRLEN(g_fen_alphabet)];
+        }
+
+        data[size++]           = '\n';
+        const size_t num_plies = next_random(&state) % MAX_PLIES;
+        for (size_t j = 0; j < num_plies; j++)
+            data[size++] = next_random(&state) & 0xFF;
+
+        LLVMFuzzerTestOneInput(data, size);
+    }
+}
+
+int main(int argc, char** argv) {
+    if (argc >= 3 && strcmp(argv[1], "--random") == 0) {
+        const unsigned long count = strtoul(argv[2], NULL, 10);
+        const uint64_t seed = (argc >= 4) ? strtoull(argv[3], NULL, 10) : 1;
+        run_random(count, seed);
+        printf("Checked %lu random inputs.\n", count);
+        return 0;
+    }
+
+    /* Without arguments, the input is read from stdin, as expected by AFL */
+    if (argc < 2)
+        return run_file(NULL) ? 0 : 1;
+
+    for (int i = 1; i < argc; i++)
+        if (!run_file(argv[i]))
+            return 1;
+
+    return 0;
+}
+
+#endif /* CHESS_FUZZ_LIBFUZZER */
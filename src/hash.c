@@ -0,0 +1,67 @@
+/*
+ * Copyright 2025 8dcc
+ *
+ * This file is part of 8dcc's Chess.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "include/hash.h"
+
+/*
+ * Seed of the pseudo-random generator used for the keys. Changing it
+ * invalidates all stored hashes (e.g. position indexes).
+ */
+#define HASH_SEED 0x8DCC8DCC8DCC8DCCULL
+
+HashKeys g_hash_keys;
+
+/*----------------------------------------------------------------------------*/
+
+/*
+ * Return the next number of the SplitMix64 pseudo-random generator.
+ */
+static uint64_t splitmix64(uint64_t* state) {
+    uint64_t z = (*state += 0x9E3779B97F4A7C15ULL);
+    z          = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ULL;
+    z          = (z ^ (z >> 27)) * 0x94D049BB133111EBULL;
+    return z ^ (z >> 31);
+}
+
+void hash_init(void) {
+    static bool initialized = false;
+    if (initialized)
+        return;
+
+    uint64_t state = HASH_SEED;
+
+    for (int color = 0; color < 3; color++)
+        for (int type = 0; type < 7; type++)
+            for (int cell = 0; cell < HASH_MAX_CELLS; cell++)
+                g_hash_keys.pieces[color][type][cell] = splitmix64(&state);
+
+    /* No castling rights means no key, so the empty state hashes to zero */
+    g_hash_keys.castling[0] = 0;
+    for (int i = 1; i < 16; i++)
+        g_hash_keys.castling[i] = splitmix64(&state);
+
+    for (int col = 0; col < HASH_MAX_CELLS; col++)
+        g_hash_keys.en_passant[col] = splitmix64(&state);
+
+    g_hash_keys.black_turn = splitmix64(&state);
+
+    initialized = true;
+}
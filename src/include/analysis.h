@@ -0,0 +1,93 @@
+/*
+ * Copyright 2025 8dcc
+ *
+ * This file is part of 8dcc's Chess.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef ANALYSIS_H_
+#define ANALYSIS_H_ 1
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include <pthread.h>
+
+#include "board.h"
+#include "clock.h"
+#include "piece.h"
+#include "search.h"
+
+/*
+ * Structure representing a multi-PV search running in a background thread,
+ * whose results are published after each completed depth, so they can be
+ * shown while the search continues.
+ */
+typedef struct Analysis {
+    pthread_t thread;
+    Search search;
+
+    /* Hash of the analyzed position */
+    uint64_t hash;
+
+    /*
+     * Copy of the game clock when the analysis started, and color to move,
+     * used for limiting the time of the search. Only used if 'use_clock' is
+     * set.
+     */
+    bool use_clock;
+    GameClock clock;
+    enum EPieceColor turn;
+
+    /*
+     * Results of the last completed depth, and number of times they were
+     * published, protected by the mutex.
+     */
+    pthread_mutex_t mutex;
+    SearchResult result;
+    unsigned generation;
+} Analysis;
+
+/*----------------------------------------------------------------------------*/
+
+/*
+ * Start analyzing the position of the specified board, which is copied, for
+ * finding the specified number of lines. After successfuly calling this
+ * function, the caller is responsible for stopping it with 'analysis_stop'.
+ *
+ * If 'clock' is not NULL, the search only uses the time that the player to
+ * move would spend on the move with that clock (see 'timeman_init'), instead
+ * of running until it's stopped.
+ *
+ * This function returns true on success, or false on error.
+ */
+bool analysis_start(Analysis* analysis, const Board* board, size_t num_lines,
+                    const GameClock* clock);
+
+/*
+ * Stop the analysis, waiting for its thread to finish.
+ */
+void analysis_stop(Analysis* analysis);
+
+/*
+ * Copy the results of the analysis into 'dst' if they were updated since the
+ * specified generation, which is then updated.
+ *
+ * This function returns true if 'dst' was updated, or false otherwise.
+ */
+bool analysis_poll(Analysis* analysis, SearchResult* dst,
+                   unsigned* generation);
+
+#endif /* ANALYSIS_H_ */
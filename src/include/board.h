@@ -21,9 +21,11 @@
 
 #include <stddef.h>
 #include <stdbool.h>
+#include <stdint.h>
 #include <assert.h>
 
 #include "piece.h"
+#include "variant.h"
 
 /*
  * Structure representing a coordinate in the board. The enumerations for the X
@@ -62,6 +64,36 @@ typedef struct BoardCoordinate {
     } y;
 } BoardCoordinate;
 
+/*
+ * Flags representing the castling rights of each player, which can be combined
+ * in the 'Board.castling' member.
+ */
+enum EBoardCastling {
+    BOARD_CASTLE_NONE        = 0,
+    BOARD_CASTLE_WHITE_KING  = (1 << 0),
+    BOARD_CASTLE_WHITE_QUEEN = (1 << 1),
+    BOARD_CASTLE_BLACK_KING  = (1 << 2),
+    BOARD_CASTLE_BLACK_QUEEN = (1 << 3),
+    BOARD_CASTLE_ALL         = 0xF,
+};
+
+/*
+ * Index of the standard initial position in the Chess960 numbering, see
+ * 'board_set_chess960_layout'.
+ */
+#define BOARD_CHESS960_STANDARD 518
+
+/*
+ * Number of Chess960 initial positions.
+ */
+#define BOARD_CHESS960_COUNT 960
+
+/*
+ * Maximum length of a FEN string generated by 'board_get_fen' for a standard
+ * board, including the null terminator.
+ */
+#define BOARD_FEN_MAX 100
+
 /*
  * Structure representing a single cell of a chess board, independently on
  * whether or not it has a piece on it.
@@ -97,12 +129,62 @@ typedef struct Board {
 
     /* Position of the player selection, in cells */
     BoardCoordinate selection;
+
+    /* Color of the player that should move next */
+    enum EPieceColor turn;
+
+    /* Castling rights of both players, see 'EBoardCastling' */
+    int castling;
+
+    /*
+     * Column of the rook used by each castling right, indexed by the bit of
+     * the right in 'EBoardCastling' (see 'board_castling_index'). In standard
+     * chess, these are the H and A columns, but they can be any column in
+     * Chess960.
+     */
+    int castling_rook_x[4];
+
+    /*
+     * Cell that can be captured en passant in the next move, or 'NONE' if the
+     * last move was not a pawn double push.
+     */
+    BoardCoordinate en_passant;
+
+    /* Plies since the last capture or pawn move, for the fifty-move rule */
+    int halfmove_clock;
+
+    /* Number of the current move, starting at 1 and incremented after black */
+    int fullmove_number;
+
+    /*
+     * Zobrist hash of the position, including the pieces, turn, castling
+     * rights and en passant cell, if it can be captured (see
+     * 'move_can_capture_en_passant'). Updated incrementally when making moves.
+     */
+    uint64_t hash;
+
+    /*
+     * Key of the en passant cell included in 'hash', or zero if it's not
+     * included, so it can be removed without checking the capture again. See
+     * 'board_en_passant_key'.
+     */
+    uint64_t en_passant_key;
+
+    /*
+     * Static evaluation of the position from the point of view of white, in
+     * centipawns. Updated incrementally when making moves, see "eval.h".
+     */
+    int eval;
+
+    /* Variant whose rules are used for this board, see "rules.h" */
+    enum EVariant variant;
 } Board;
 
 /*----------------------------------------------------------------------------*/
 
 /*
- * Initialize a 'Board' structure with the specified width and height. After
+ * Initialize a 'Board' structure with the specified width and height, which
+ * should not have more than 'HASH_MAX_CELLS' cells. After
  * successfuly calling this function, the caller is responsible for
  * deinitializing it with 'board_destroy'.
  *
@@ -116,11 +198,63 @@ bool board_init(Board* board, size_t width, size_t height);
  */
 void board_destroy(Board* board);
 
+/*
+ * Copy the pieces and state of the 'src' board into 'dst', which should have
+ * the same dimensions. The cursor and selection of 'dst' are not modified.
+ * Callers with a 'MoveCache' for 'dst' should invalidate it afterwards.
+ */
+void board_copy_position(Board* dst, const Board* src);
+
 /*
  * Set the initial layout of a chess board.
  */
 bool board_set_initial_layout(Board* board);
 
+/*
+ * Set one of the 960 initial layouts of Chess960, using the standard numbering
+ * of Reinhard Scharnagl. The index 'BOARD_CHESS960_STANDARD' corresponds to the
+ * initial layout of standard chess.
+ *
+ * This function returns true on success, or false if the index is not valid.
+ */
+bool board_set_chess960_layout(Board* board, int index);
+
+/*
+ * Set the layout and state of a chess board from a string in Forsyth-Edwards
+ * Notation. The dimensions of the position should match the ones of the board.
+ *
+ * This function returns true on success, or false if the string is not valid.
+ * On error, the board contents are undefined.
+ */
+bool board_set_fen(Board* board, const char* fen);
+
+/*
+ * Write the layout and state of a chess board as a null-terminated string in
+ * Forsyth-Edwards Notation. The output is truncated to 'size' bytes.
+ *
+ * This function returns true on success, or false if the string didn't fit in
+ * the buffer.
+ */
+bool board_get_fen(const Board* board, char* dst, size_t size);
+
+/*
+ * Compute the Zobrist hash of the current position from scratch. The result
+ * should always match the 'hash' member.
+ */
+uint64_t board_compute_hash(const Board* board);
+
+/*
+ * Return the hash key of the en passant cell of the board if the player to
+ * move can capture it, or zero otherwise.
+ */
+uint64_t board_en_passant_key(const Board* board);
+
+/*
+ * Compute the static evaluation of the current position from scratch. The
+ * result should always match the 'eval' member.
+ */
+int board_compute_eval(const Board* board);
+
 /*----------------------------------------------------------------------------*/
 
 /*
@@ -132,6 +266,34 @@ static inline BoardCell* board_cell_at(const Board* board,
     return &board->cells[board->width * coord.y + coord.x];
 }
 
+/*
+ * Return the castling right of the specified color on the king side (towards
+ * the H column) or on the queen side (towards the A column).
+ */
+static inline enum EBoardCastling board_castling_right(enum EPieceColor color,
+                                                       bool king_side) {
+    if (color == PIECE_COL_WHITE)
+        return king_side ? BOARD_CASTLE_WHITE_KING : BOARD_CASTLE_WHITE_QUEEN;
+    else
+        return king_side ? BOARD_CASTLE_BLACK_KING : BOARD_CASTLE_BLACK_QUEEN;
+}
+
+/*
+ * Return the index of a single castling right in 'Board.castling_rook_x'.
+ */
+static inline int board_castling_index(enum EBoardCastling right) {
+    switch (right) {
+        case BOARD_CASTLE_WHITE_KING:
+            return 0;
+        case BOARD_CASTLE_WHITE_QUEEN:
+            return 1;
+        case BOARD_CASTLE_BLACK_KING:
+            return 2;
+        default:
+            return 3;
+    }
+}
+
 /*
  * Get the character used to display a cell of a chess board.
  */
@@ -144,6 +306,9 @@ static inline char board_cell_get_char(BoardCell* cell) {
  * valid and compatible with each other.
  */
 static inline void board_assert_integrity(const Board* board) {
+    /* Avoid warnings when assertions are disabled */
+    (void)board;
+
     /* The cursor coordinates should not be out of range */
     assert(board->cursor.x < board->width && board->cursor.y < board->height);
 
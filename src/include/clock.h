@@ -0,0 +1,115 @@
+/*
+ * Copyright 2025 8dcc
+ *
+ * This file is part of 8dcc's Chess.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef CLOCK_H_
+#define CLOCK_H_ 1
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "piece.h"
+
+/*
+ * Structure representing a pair of chess clocks, one for each player. All times
+ * are in milliseconds, and they are measured with a monotonic clock, so they
+ * are not affected by changes to the system time.
+ *
+ * The 'moves_to_go' member specifies the number of moves in each time control
+ * period; when a player completes them, the base time is added again to their
+ * clock. A value of zero means that the base time is used for the whole game
+ * (i.e. sudden death, with an optional increment).
+ */
+typedef struct GameClock {
+    /* Time control, as specified by the user */
+    int64_t base_ms;
+    int64_t increment_ms;
+    int moves_to_go;
+
+    /*
+     * Remaining time and moves until the next time control of each player,
+     * indexed with white first. The remaining time doesn't include the
+     * time elapsed since the last call to 'clock_press'.
+     */
+    int64_t remaining_ms[2];
+    int moves_left[2];
+
+    /* Color whose clock is currently running, or 'PIECE_COL_UNKNOWN' */
+    enum EPieceColor running;
+
+    /* Monotonic time when the running clock was last started */
+    int64_t started_ms;
+} GameClock;
+
+/*----------------------------------------------------------------------------*/
+
+/*
+ * Return the current time of the monotonic clock, in milliseconds. The value is
+ * only meaningful when compared with other values returned by this function.
+ */
+int64_t clock_now_ms(void);
+
+/*
+ * Initialize a 'GameClock' structure with the specified time control. None of
+ * the clocks will be running after the initialization.
+ */
+void clock_init(GameClock* clock, int64_t base_ms, int64_t increment_ms,
+                int moves_to_go);
+
+/*
+ * Parse a time control with the format "MINUTES[+INCREMENT][/MOVES]", where
+ * the increment is specified in seconds, and initialize the clock with it.
+ *
+ * This function returns true on success, or false if the string is not valid.
+ */
+bool clock_init_from_str(GameClock* clock, const char* str);
+
+/*
+ * Start the clock of the specified color, stopping the other one without
+ * applying any increment.
+ */
+void clock_start(GameClock* clock, enum EPieceColor color);
+
+/*
+ * Stop the running clock, apply the increment and the moves-to-go logic to it,
+ * and start the clock of the opponent. Does nothing if no clock was running, or
+ * if the running side has already lost on time.
+ */
+void clock_press(GameClock* clock);
+
+/*
+ * Return the remaining time of the specified color, in milliseconds, including
+ * the time elapsed since the clock was last started. The returned value is
+ * never negative.
+ */
+int64_t clock_remaining_ms(const GameClock* clock, enum EPieceColor color);
+
+/*
+ * Return the number of moves that the specified color has to play until the
+ * next time control, or zero if the time control has no moves-to-go.
+ */
+int clock_moves_left(const GameClock* clock, enum EPieceColor color);
+
+/*
+ * Check if the specified color has run out of time.
+ */
+static inline bool clock_is_flagged(const GameClock* clock,
+                                    enum EPieceColor color) {
+    return clock_remaining_ms(clock, color) <= 0;
+}
+
+#endif /* CLOCK_H_ */
@@ -0,0 +1,68 @@
+/*
+ * Copyright 2025 8dcc
+ *
+ * This file is part of 8dcc's Chess.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef EVAL_H_
+#define EVAL_H_ 1
+
+#include "board.h"
+#include "piece.h"
+
+/*
+ * Weights of the static evaluation, in centipawns, indexed by 'EPieceType'.
+ * Should only be accessed through the functions below.
+ *
+ * The value of a piece is its material, plus its centralization weight for
+ * each row and column that it's away from the edges, plus its advancement
+ * weight for each row that it's away from the first row of its player.
+ */
+extern const int g_eval_material[7];
+extern const int g_eval_centralization[7];
+extern const int g_eval_advancement[7];
+
+/*----------------------------------------------------------------------------*/
+
+/*
+ * Return the value of the specified piece at the specified cell, from the
+ * point of view of white. The static evaluation of a position is the sum of
+ * the values of its pieces, so it can be updated incrementally when making a
+ * move, like the Zobrist hash.
+ */
+static inline int eval_piece(const Board* board, const Piece* piece, int x,
+                             int y) {
+    const int edge_x  = (x < board->width - 1 - x) ? x : board->width - 1 - x;
+    const int edge_y  = (y < board->height - 1 - y) ? y : board->height - 1 - y;
+    const int advance = (piece->color == PIECE_COL_WHITE)
+                          ? board->height - 1 - y
+                          : y;
+
+    const int value = g_eval_material[piece->type] +
+                      g_eval_centralization[piece->type] * (edge_x + edge_y) +
+                      g_eval_advancement[piece->type] * advance;
+
+    return (piece->color == PIECE_COL_WHITE) ? value : -value;
+}
+
+/*
+ * Return the static evaluation of the position, from the point of view of the
+ * player in turn.
+ */
+static inline int eval_relative(const Board* board) {
+    return (board->turn == PIECE_COL_WHITE) ? board->eval : -board->eval;
+}
+
+#endif /* EVAL_H_ */
@@ -0,0 +1,85 @@
+/*
+ * Copyright 2025 8dcc
+ *
+ * This file is part of 8dcc's Chess.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef HASH_H_
+#define HASH_H_ 1
+
+#include <stdint.h>
+
+#include "piece.h"
+
+/*
+ * Maximum number of board cells supported by the Zobrist keys.
+ */
+#define HASH_MAX_CELLS 64
+
+/*
+ * Random keys used for computing Zobrist hashes of chess positions. The hash of
+ * a position is the XOR of the keys of its pieces and state, so it can be
+ * updated incrementally when making a move. Should only be accessed through the
+ * functions below.
+ */
+typedef struct HashKeys {
+    uint64_t pieces[3][7][HASH_MAX_CELLS]; /* [EPieceColor][EPieceType] */
+    uint64_t castling[16];                 /* EBoardCastling combinations */
+    uint64_t en_passant[HASH_MAX_CELLS];   /* Column of the en passant cell */
+    uint64_t black_turn;
+} HashKeys;
+
+extern HashKeys g_hash_keys;
+
+/*----------------------------------------------------------------------------*/
+
+/*
+ * Initialize the global Zobrist keys. The keys are always the same, so hashes
+ * can be stored and compared across runs. This function is called from
+ * 'board_init', and it does nothing after the first call, so it must be called
+ * before starting any threads.
+ */
+void hash_init(void);
+
+/*
+ * Return the key of the specified piece at the specified cell index.
+ */
+static inline uint64_t hash_piece(const Piece* piece, int cell) {
+    return g_hash_keys.pieces[piece->color][piece->type][cell];
+}
+
+/*
+ * Return the key of the specified castling rights.
+ */
+static inline uint64_t hash_castling(int castling) {
+    return g_hash_keys.castling[castling];
+}
+
+/*
+ * Return the key of an en passant cell in the specified column.
+ */
+static inline uint64_t hash_en_passant(int col) {
+    return g_hash_keys.en_passant[col];
+}
+
+/*
+ * Return the key of the side to move, which is only used when black is to
+ * move.
+ */
+static inline uint64_t hash_black_turn(void) {
+    return g_hash_keys.black_turn;
+}
+
+#endif /* HASH_H_ */
@@ -0,0 +1,99 @@
+/*
+ * Copyright 2025 8dcc
+ *
+ * This file is part of 8dcc's Chess.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef INDEX_H_
+#define INDEX_H_ 1
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+/*
+ * Structure representing the statistics of a single position in an index. It's
+ * also the format of each entry in the index files, which are stored in the
+ * native byte order.
+ */
+typedef struct IndexEntry {
+    uint64_t hash; /* See 'Board.hash' */
+    uint32_t white_wins;
+    uint32_t draws;
+    uint32_t black_wins;
+    uint32_t reserved;
+} IndexEntry;
+
+/*
+ * Structure representing an index file opened with 'index_open'. The entries
+ * are sorted by hash, so they can be searched without loading the whole file.
+ */
+typedef struct Index {
+    const IndexEntry* entries;
+    size_t count;
+
+    /* Memory mapping of the whole file */
+    void* mapping;
+    size_t mapping_size;
+} Index;
+
+/*----------------------------------------------------------------------------*/
+
+/*
+ * Build an index of the positions in the specified file of games, and write it
+ * to the specified output file.
+ *
+ * Each line of the input contains a game, as a list of moves in coordinate
+ * notation (e.g. "e2e4 e7e5"), followed by the result ("1-0", "0-1" or
+ * "1/2-1/2"). Move numbers (e.g. "1.") are ignored, and so are games without a
+ * result or with illegal moves.
+ *
+ * The games are split across the specified number of threads, each one with its
+ * own hash table. When the tables exceed the specified memory limit, in bytes,
+ * they are written to sorted temporary files, which are merged at the end.
+ *
+ * This function returns true on success, or false on error, after printing a
+ * message.
+ */
+bool index_build(const char* games_path, const char* output_path,
+                 int num_threads, size_t memory_limit);
+
+/*
+ * Open an index file created by 'index_build'. After successfully calling this
+ * function, the caller is responsible for closing it with 'index_close'.
+ *
+ * This function returns true on success, or false on error.
+ */
+bool index_open(Index* index, const char* path);
+
+/*
+ * Close an index opened with 'index_open'.
+ */
+void index_close(Index* index);
+
+/*
+ * Search the entry of the specified position hash in the index. Returns NULL if
+ * the position is not in the index.
+ */
+const IndexEntry* index_probe(const Index* index, uint64_t hash);
+
+/*
+ * Return the total number of games of an index entry.
+ */
+static inline uint64_t index_entry_games(const IndexEntry* entry) {
+    return (uint64_t)entry->white_wins + entry->draws + entry->black_wins;
+}
+
+#endif /* INDEX_H_ */
@@ -22,6 +22,7 @@
 #include <stdbool.h>
 
 #include "board.h"
+#include "move.h"
 
 /*
  * Enumeration representing possible user inputs.
@@ -34,6 +35,17 @@ enum EInputKey {
     INPUT_KEY_LEFT,
     INPUT_KEY_RIGHT,
     INPUT_KEY_SELECT,
+
+    /* Keys for reviewing games, see 'replay_seek' */
+    INPUT_KEY_NEXT,
+    INPUT_KEY_PREV,
+    INPUT_KEY_FIRST,
+    INPUT_KEY_LAST,
+    INPUT_KEY_GOTO,
+
+    /* Digits, in order, for typing the ply of 'INPUT_KEY_GOTO' */
+    INPUT_KEY_DIGIT_0,
+    INPUT_KEY_DIGIT_9 = INPUT_KEY_DIGIT_0 + 9,
 };
 
 /*----------------------------------------------------------------------------*/
@@ -44,14 +56,15 @@ enum EInputKey {
 enum EInputKey input_get_key(void);
 
 /*
- * Process a game key, altering the specified chess board if needed. Keys
- * unrelated to the game are not processed, so the caller is responsible for
- * the other application-level keys.
+ * Process a game key, altering the specified chess board and its move cache if
+ * needed. Keys unrelated to the game are not processed, so the caller is
+ * responsible for the other application-level keys.
  *
  * This function returns true if the key was successfully processed, or false in
  * case of error (e.g. it's not a game key, or there was an error processing a
  * valid key).
  */
-bool input_process_game_key(Board* board, enum EInputKey input_key);
+bool input_process_game_key(Board* board, MoveCache* cache,
+                            enum EInputKey input_key);
 
 #endif /* INPUT_H_ */
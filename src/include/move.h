@@ -0,0 +1,280 @@
+/*
+ * Copyright 2025 8dcc
+ *
+ * This file is part of 8dcc's Chess.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef MOVE_H_
+#define MOVE_H_ 1
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "board.h"
+#include "piece.h"
+
+/*
+ * Maximum number of moves in a 'MoveList'. No legal chess position has more
+ * than 218 moves.
+ */
+#define MOVELIST_MAX 256
+
+/*
+ * Maximum length of a move in coordinate notation (e.g. "e7e8q"), including
+ * the null terminator.
+ */
+#define MOVE_STR_MAX 6
+
+/*
+ * Flags with extra information about a 'Move', which can be combined.
+ */
+enum EMoveFlags {
+    MOVE_FLAG_NONE        = 0,
+    MOVE_FLAG_CAPTURE     = (1 << 0),
+    MOVE_FLAG_DOUBLE_PUSH = (1 << 1),
+    MOVE_FLAG_EN_PASSANT  = (1 << 2),
+    MOVE_FLAG_CASTLE      = (1 << 3),
+    MOVE_FLAG_PROMOTION   = (1 << 4),
+};
+
+/*
+ * Structure representing a single chess move. The 'promotion' member is only
+ * used if the 'MOVE_FLAG_PROMOTION' flag is set.
+ *
+ * Castling moves are stored as the king capturing its own rook, so the 'to'
+ * member is the cell of the rook, since the king might not move at all in
+ * Chess960. See 'move_castling_king_x' and 'move_castling_rook_x'.
+ */
+typedef struct Move {
+    BoardCoordinate from, to;
+    enum EPieceType promotion;
+    int flags;
+} Move;
+
+/*
+ * Structure representing a list of moves, with a fixed capacity.
+ */
+typedef struct MoveList {
+    Move moves[MOVELIST_MAX];
+    size_t count;
+} MoveList;
+
+/*
+ * Structure with the board state that is lost after calling 'move_make', and
+ * needed for restoring it with 'move_unmake'.
+ */
+typedef struct MoveUndo {
+    BoardCell captured;
+    int castling;
+    BoardCoordinate en_passant;
+    int halfmove_clock;
+    uint64_t hash;
+    uint64_t en_passant_key;
+    int eval;
+} MoveUndo;
+
+/*
+ * Highlight of a cell for the moves of the selected piece.
+ */
+enum EMoveHighlight {
+    MOVE_HIGHLIGHT_NONE,
+    MOVE_HIGHLIGHT_TARGET,  /* The selected piece can move here */
+    MOVE_HIGHLIGHT_CAPTURE, /* The selected piece can capture here */
+
+    /* Same as above, but the piece would be attacked by the opponent there */
+    MOVE_HIGHLIGHT_ATTACKED_TARGET,
+    MOVE_HIGHLIGHT_ATTACKED_CAPTURE,
+};
+
+/*
+ * Structure with information about the current position of a board that is
+ * expensive to compute, and that is only updated when the position changes,
+ * not on every redraw or cursor movement. It's owned by the user interface,
+ * not by the board, see 'move_cache_init'.
+ */
+typedef struct MoveCache {
+    /* True if 'legal' contains the legal moves of the current position */
+    bool is_valid;
+    MoveList legal;
+
+    /*
+     * Array with an 'EMoveHighlight' for each cell of the board, for the
+     * moves of the piece at 'selection'.
+     */
+    BoardCoordinate selection;
+    unsigned char* highlights;
+} MoveCache;
+
+/*----------------------------------------------------------------------------*/
+
+/*
+ * Check if the specified cell is attacked by any piece of the specified color.
+ */
+bool move_is_attacked(const Board* board, BoardCoordinate coord,
+                      enum EPieceColor attacker);
+
+/*
+ * Check if the player to move can legally capture the en passant cell of the
+ * board. Only en passant cells that can be captured are part of the hash, so
+ * transpositions that only differ in a pawn double push have the same hash.
+ */
+bool move_can_capture_en_passant(const Board* board);
+
+/*
+ * Check if the king of the specified color is currently attacked.
+ */
+bool move_in_check(const Board* board, enum EPieceColor color);
+
+/*
+ * Generate all pseudo-legal moves for the player in turn, that is, moves that
+ * follow the movement rules of each piece, but that might leave the king of
+ * the player in check. Castling moves are only generated if the king is not
+ * in check and doesn't pass through attacked cells, but they might still leave
+ * the king in check in Chess960, if the castling rook was blocking an attack
+ * to its destination.
+ */
+void move_generate_pseudo_legal(const Board* board, MoveList* list);
+
+/*
+ * Generate all legal moves for the player in turn. The board is temporarily
+ * modified while checking each move, but it's restored before returning. No
+ * moves are generated if the player already lost because of the rules of the
+ * variant (see "rules.h").
+ */
+void move_generate_legal(Board* board, MoveList* list);
+
+/*
+ * Make the specified move in the board, which should be pseudo-legal. The
+ * information needed for undoing the move is stored in the 'undo' argument.
+ */
+void move_make(Board* board, const Move* move, MoveUndo* undo);
+
+/*
+ * Undo the specified move, which should be the last one made in the board,
+ * using the information stored by 'move_make'.
+ */
+void move_unmake(Board* board, const Move* move, const MoveUndo* undo);
+
+/*
+ * Count the number of leaf nodes in the legal move tree of the specified depth,
+ * following the rules of the variant of the board. Used for verifying and
+ * benchmarking the move generation.
+ */
+uint64_t move_perft(Board* board, int depth);
+
+/*
+ * Find the legal move of the current position that matches the specified
+ * string in coordinate notation (e.g. "e2e4" or "e7e8q"), and store it in
+ * 'dst'. Returns false if there is no such legal move.
+ */
+bool move_from_str(Board* board, const char* str, Move* dst);
+
+/*
+ * Make the legal move from the 'from' cell to the 'to' cell, if there is one.
+ * Pawns are always promoted to queens. The specified move cache, which can be
+ * NULL, is used for finding the move, and it's invalidated afterwards.
+ *
+ * This function returns true if the move was made, or false if it's not legal.
+ */
+bool move_make_legal(Board* board, MoveCache* cache, BoardCoordinate from,
+                     BoardCoordinate to);
+
+/*
+ * Initialize a 'MoveCache' for boards with the dimensions of the specified
+ * board. After successfully calling this function, the caller is responsible
+ * for deinitializing it with 'move_cache_destroy'.
+ *
+ * This function returns true on success, or false on error.
+ */
+bool move_cache_init(MoveCache* cache, const Board* board);
+
+/*
+ * Free the data of the specified 'MoveCache'.
+ */
+void move_cache_destroy(MoveCache* cache);
+
+/*
+ * Invalidate the specified 'MoveCache'. Must be called whenever the position
+ * of its board changes outside of 'move_make_legal'.
+ */
+void move_cache_invalidate(MoveCache* cache);
+
+/*
+ * Return the legal moves of the current position of the specified board,
+ * computing them only if they are not cached.
+ */
+const MoveList* move_cache_get_legal(MoveCache* cache, Board* board);
+
+/*
+ * Update the highlights of the specified 'MoveCache' for the current selection
+ * of the board. Must be called whenever the selection changes.
+ */
+void move_cache_update_selection(MoveCache* cache, Board* board);
+
+/*
+ * Return the highlight of the specified cell for the current selection. The
+ * cache can be NULL, in which case no cell is highlighted.
+ */
+static inline enum EMoveHighlight move_cache_get_highlight(
+  const MoveCache* cache, const Board* board, BoardCoordinate coord) {
+    if (cache == NULL || cache->selection.x != board->selection.x ||
+        cache->selection.y != board->selection.y)
+        return MOVE_HIGHLIGHT_NONE;
+
+    return cache->highlights[board->width * coord.y + coord.x];
+}
+
+/*
+ * Write the specified move in coordinate notation (e.g. "e2e4" or "e7e8q") to
+ * the specified buffer, which should have at least 'MOVE_STR_MAX' bytes.
+ *
+ * Castling moves from the standard cells are written with the destination of
+ * the king (e.g. "e1g1"), and other castling moves are written as the king
+ * capturing its own rook (e.g. "b1a1"), like in the UCI protocol for Chess960.
+ */
+void move_to_str(const Move* move, char* dst);
+
+/*
+ * Check if two moves are the same.
+ */
+static inline bool move_equal(const Move* a, const Move* b) {
+    if (a->from.x != b->from.x || a->from.y != b->from.y ||
+        a->to.x != b->to.x || a->to.y != b->to.y)
+        return false;
+
+    if ((a->flags & MOVE_FLAG_PROMOTION) != (b->flags & MOVE_FLAG_PROMOTION))
+        return false;
+
+    return (a->flags & MOVE_FLAG_PROMOTION) == 0 ||
+           a->promotion == b->promotion;
+}
+
+/*
+ * Return the column where the king ends after the specified castling move.
+ */
+static inline int move_castling_king_x(const Move* move) {
+    /* TODO: Support arbitrary board dimensions */
+    return (move->to.x > move->from.x) ? BOARD_COL_G : BOARD_COL_C;
+}
+
+/*
+ * Return the column where the rook ends after the specified castling move.
+ */
+static inline int move_castling_rook_x(const Move* move) {
+    return (move->to.x > move->from.x) ? BOARD_COL_F : BOARD_COL_D;
+}
+
+#endif /* MOVE_H_ */
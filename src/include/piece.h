@@ -19,6 +19,8 @@
 #ifndef PIECE_H_
 #define PIECE_H_ 1
 
+#include <stdbool.h>
+
 /*
  * Enumeration representing available types of chess pieces.
  */
@@ -55,7 +57,7 @@ typedef struct Piece {
  * Get the character used to display a chess piece.
  */
 static inline char piece_get_char(const Piece* piece) {
-    char result;
+    char result = '?';
 
     /* clang-format off */
     switch (piece->type) {
@@ -73,4 +75,39 @@ static inline char piece_get_char(const Piece* piece) {
     return result;
 }
 
+/*
+ * Get the chess piece represented by a character in Forsyth-Edwards Notation,
+ * where uppercase letters are white pieces, and lowercase letters are black
+ * pieces.
+ *
+ * This function returns true on success, or false if the character doesn't
+ * represent a valid piece.
+ */
+static inline bool piece_from_fen_char(char c, Piece* piece) {
+    piece->color = (c >= 'a' && c <= 'z') ? PIECE_COL_BLACK : PIECE_COL_WHITE;
+
+    /* clang-format off */
+    switch (c) {
+        case 'P': case 'p': piece->type = PIECE_TYPE_PAWN;   break;
+        case 'R': case 'r': piece->type = PIECE_TYPE_ROOK;   break;
+        case 'N': case 'n': piece->type = PIECE_TYPE_KNIGHT; break;
+        case 'B': case 'b': piece->type = PIECE_TYPE_BISHOP; break;
+        case 'Q': case 'q': piece->type = PIECE_TYPE_QUEEN;  break;
+        case 'K': case 'k': piece->type = PIECE_TYPE_KING;   break;
+        default:            return false;
+    }
+    /* clang-format on */
+
+    return true;
+}
+
+/*
+ * Get the character used to represent a chess piece in Forsyth-Edwards
+ * Notation. See 'piece_from_fen_char'.
+ */
+static inline char piece_get_fen_char(const Piece* piece) {
+    const char c = piece_get_char(piece);
+    return (piece->color == PIECE_COL_BLACK) ? c - 'A' + 'a' : c;
+}
+
 #endif /* PIECE_H_ */
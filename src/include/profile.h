@@ -0,0 +1,123 @@
+/*
+ * Copyright 2025 8dcc
+ *
+ * This file is part of 8dcc's Chess.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef PROFILE_H_
+#define PROFILE_H_ 1
+
+#include <stdint.h>
+#include <stdio.h>
+
+/*
+ * Enumeration with the code regions that can be measured with the profiling
+ * macros. Each span stores the number of times it was entered, and the total
+ * number of ticks spent inside it.
+ *
+ * The evaluation is updated incrementally when making moves, which is measured
+ * by the 'make_move' span, so the 'eval' span only covers the evaluations
+ * computed from scratch and the static evaluations of the search.
+ */
+enum EProfileSpan {
+    PROFILE_SPAN_RENDER,
+    PROFILE_SPAN_INPUT,
+    PROFILE_SPAN_MAKE_MOVE,
+    PROFILE_SPAN_MOVEGEN,
+    PROFILE_SPAN_EVAL,
+    PROFILE_SPAN_INDEX_INSERT,
+    PROFILE_SPAN_INDEX_PROBE,
+    PROFILE_SPAN_SEARCH,
+
+    NUM_PROFILE_SPANS, /* Must be last */
+};
+
+/*
+ * Structure with the profiling counters of a single thread.
+ */
+typedef struct ProfileCounters {
+    uint64_t calls[NUM_PROFILE_SPANS];
+    uint64_t ticks[NUM_PROFILE_SPANS];
+} ProfileCounters;
+
+/*----------------------------------------------------------------------------*/
+
+/*
+ * Start the profiler, storing the reference time used for converting ticks to
+ * seconds in the final report.
+ */
+void profile_startup(void);
+
+/*
+ * Add the counters of the calling thread to the global counters, and reset
+ * them. Must be called by each thread before it exits, including the main
+ * thread before printing the report.
+ */
+void profile_merge_thread(void);
+
+/*
+ * Print a table with the global profiling counters to the specified file. If
+ * the profiler was disabled at compile-time, a single line is printed instead.
+ */
+void profile_print_report(FILE* fp);
+
+/*----------------------------------------------------------------------------*/
+
+#ifdef CHESS_PROFILE
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+/*
+ * Counters of the current thread. Should only be accessed through the macros
+ * below.
+ */
+extern __thread ProfileCounters g_profile_thread_counters;
+
+/*
+ * Return the current value of a monotonic counter. On x86, the time-stamp
+ * counter is used; otherwise, the monotonic clock is used, in nanoseconds.
+ */
+uint64_t profile_ticks_slow(void);
+static inline uint64_t profile_ticks(void) {
+#if defined(__x86_64__) || defined(__i386__)
+    return __rdtsc();
+#else
+    return profile_ticks_slow();
+#endif
+}
+
+/*
+ * Start and end a profiling span. Both macros must be used in the same scope,
+ * and each span can only be started once per scope.
+ */
+#define PROFILE_BEGIN(SPAN)                                                    \
+    const uint64_t profile_start_##SPAN = profile_ticks()
+#define PROFILE_END(SPAN)                                                      \
+    do {                                                                       \
+        g_profile_thread_counters.calls[SPAN]++;                               \
+        g_profile_thread_counters.ticks[SPAN] +=                               \
+          profile_ticks() - profile_start_##SPAN;                              \
+    } while (0)
+
+#else /* !CHESS_PROFILE */
+
+#define PROFILE_BEGIN(SPAN) ((void)0)
+#define PROFILE_END(SPAN)   ((void)0)
+
+#endif /* !CHESS_PROFILE */
+
+#endif /* PROFILE_H_ */
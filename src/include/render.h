@@ -20,14 +20,51 @@
 #define RENDER_H_ 1
 
 #include <stdbool.h>
+#include <stdio.h>
 
 #include "board.h"
+#include "clock.h"
+#include "index.h"
+#include "move.h"
+#include "search.h"
 
+/*
+ * Optional information rendered around the board. Members that are NULL are
+ * not rendered.
+ */
+typedef struct RenderInfo {
+    /* Clocks of the game, rendered next to the board */
+    const GameClock* clock;
+
+    /* Results of the games with the current position, rendered below it */
+    const IndexEntry* stats;
+
+    /* Line of text rendered below the board, e.g. the ply of a replay */
+    const char* status;
+
+    /* Lines of the analysis, rendered next to the board */
+    const SearchResult* analysis;
+
+    /* Highlights of the moves of the selected piece, rendered in the board */
+    const MoveCache* move_cache;
+} RenderInfo;
+
+/*----------------------------------------------------------------------------*/
+
+/*
+ * Start rendering data through the "ncurses" library. If 'periodic' is true,
+ * reading input times out periodically, so the screen can be updated without
+ * user input (e.g. for the clocks). Otherwise, reading input blocks until a key
+ * is pressed.
+ */
+bool render_startup(bool periodic);
 
 /*
- * Start rendering data through the "ncurses" library.
+ * Start rendering data through the "ncurses" library, writing the output to the
+ * specified file instead of the terminal. Used for benchmarking the renderer
+ * without a terminal.
  */
-bool render_startup(void);
+bool render_startup_headless(FILE* output);
 
 /*
  * Stop rendering data.
@@ -35,8 +72,9 @@ bool render_startup(void);
 void render_cleanup(void);
 
 /*
- * Render the specified board with the "ncurses" library.
+ * Render the specified board with the "ncurses" library, along with the
+ * optional information of the 'info' argument, which can be NULL.
  */
-bool render_board(const Board* board);
+bool render_board(const Board* board, const RenderInfo* info);
 
 #endif /* RENDER_H_ */
@@ -0,0 +1,83 @@
+/*
+ * Copyright 2025 8dcc
+ *
+ * This file is part of 8dcc's Chess.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef REPLAY_H_
+#define REPLAY_H_ 1
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#include "board.h"
+#include "move.h"
+
+/*
+ * Number of plies between the board snapshots stored by a 'Replay'. Seeking to
+ * any ply needs at most this number of moves to be made or unmade.
+ */
+#define REPLAY_KEYFRAME_INTERVAL 32
+
+/*
+ * Structure representing a game that is being reviewed. Instead of storing the
+ * position of each ply, it stores a copy of the board every
+ * 'REPLAY_KEYFRAME_INTERVAL' plies (keyframes), and the moves in between,
+ * which are replayed from the nearest keyframe when seeking.
+ */
+typedef struct Replay {
+    /* Moves of the game, and the information needed for unmaking each one */
+    Move* moves;
+    MoveUndo* undos;
+    size_t num_plies;
+
+    /* Position before the ply 'i * REPLAY_KEYFRAME_INTERVAL' of the game */
+    Board* keyframes;
+    size_t num_keyframes;
+
+    /* Ply of the position shown in the reviewed board, zero being the start */
+    size_t ply;
+} Replay;
+
+/*----------------------------------------------------------------------------*/
+
+/*
+ * Load the first game of the specified file into a 'Replay' structure, using
+ * the same format as the games of 'index_build'. The game starts from the
+ * current position of the board (e.g. a Chess960 layout), and the board should
+ * be used for all calls to 'replay_seek'. After successfuly calling this
+ * function, the caller is responsible for deinitializing the replay with
+ * 'replay_destroy'.
+ *
+ * This function returns true on success, or false on error (e.g. the file
+ * contains an illegal move).
+ */
+bool replay_load(Replay* replay, Board* board, const char* path);
+
+/*
+ * Free the moves and keyframes of a 'Replay' structure. It doesn't free the
+ * argument pointer itself.
+ */
+void replay_destroy(Replay* replay);
+
+/*
+ * Set the specified board to the position at the specified ply of the game,
+ * which is limited to the number of plies. The board should be the one that
+ * was passed to 'replay_load'. Like 'board_copy_position', it doesn't
+ * invalidate any 'MoveCache' of the board.
+ */
+void replay_seek(Replay* replay, Board* board, size_t ply);
+
+#endif /* REPLAY_H_ */
@@ -0,0 +1,90 @@
+/*
+ * Copyright 2025 8dcc
+ *
+ * This file is part of 8dcc's Chess.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef RULES_H_
+#define RULES_H_ 1
+
+#include <stdbool.h>
+
+#include "board.h"
+#include "piece.h"
+#include "variant.h"
+
+/*
+ * Rules interface of the variants. Each variant in 'VARIANT_LIST' implements
+ * the following functions, with its name as suffix:
+ *
+ *   - 'rules_is_lost_<name>': Check if the player in turn already lost the
+ *     game because of a rule of the variant, independently of the available
+ *     moves. Called at every node of the perft and the search.
+ *
+ * The code of the inner loops is instantiated once per variant, so these
+ * calls are resolved at compile time, and the rules of standard chess are
+ * optimized out. The 'rules_*' functions without suffix dispatch at runtime,
+ * and they should only be used outside of the inner loops.
+ */
+
+/*----------------------------------------------------------------------------*/
+
+static inline bool rules_is_lost_standard(const Board* board) {
+    (void)board;
+    return false;
+}
+
+/*
+ * King of the Hill: a player also wins by moving the king to one of the four
+ * center cells.
+ */
+static inline bool rules_is_lost_king_of_the_hill(const Board* board) {
+    const enum EPieceColor opponent =
+      (board->turn == PIECE_COL_WHITE) ? PIECE_COL_BLACK : PIECE_COL_WHITE;
+
+    for (int y = board->height / 2 - 1; y <= board->height / 2; y++) {
+        for (int x = board->width / 2 - 1; x <= board->width / 2; x++) {
+            const BoardCell* cell =
+              board_cell_at(board, (BoardCoordinate){ x, y });
+            if (cell->has_piece && cell->piece.type == PIECE_TYPE_KING &&
+                cell->piece.color == opponent)
+                return true;
+        }
+    }
+
+    return false;
+}
+
+/*----------------------------------------------------------------------------*/
+
+#define RULES_DISPATCH_IS_LOST(NAME, VARIANT)                                  \
+    case VARIANT:                                                              \
+        return rules_is_lost_##NAME(board);
+
+/*
+ * Check if the player in turn lost because of a rule of the variant of the
+ * board. See 'rules_is_lost_<name>'.
+ */
+static inline bool rules_is_lost(const Board* board) {
+    switch (board->variant) {
+        VARIANT_LIST(RULES_DISPATCH_IS_LOST)
+    }
+
+    return false;
+}
+
+#undef RULES_DISPATCH_IS_LOST
+
+#endif /* RULES_H_ */
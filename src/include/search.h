@@ -0,0 +1,178 @@
+/*
+ * Copyright 2025 8dcc
+ *
+ * This file is part of 8dcc's Chess.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SEARCH_H_
+#define SEARCH_H_ 1
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "board.h"
+#include "move.h"
+#include "timeman.h"
+
+/*
+ * Maximum number of principal variations (lines) of a multi-PV search.
+ */
+#define SEARCH_MAX_LINES 8
+
+/*
+ * Maximum depth of the search, including the quiescence search, in plies. It
+ * also limits the length of the principal variations.
+ */
+#define SEARCH_MAX_PLY 64
+
+/*
+ * Scores of the search, in centipawns. Mate scores are 'SEARCH_SCORE_MATE'
+ * minus the number of plies until the mate, so they can be distinguished from
+ * the evaluation with 'search_is_mate_score'.
+ */
+#define SEARCH_SCORE_INFINITE 32000
+#define SEARCH_SCORE_MATE     31000
+
+/*
+ * Structure representing a principal variation found by the search, starting
+ * with one of the root moves.
+ */
+typedef struct SearchLine {
+    /* Score of the line, from the point of view of white */
+    int score;
+
+    Move moves[SEARCH_MAX_PLY];
+    size_t length;
+} SearchLine;
+
+/*
+ * Structure with the results of a completed iteration of the search. The lines
+ * are sorted from best to worst for the player in turn.
+ */
+typedef struct SearchResult {
+    int depth;
+    uint64_t nodes;
+
+    SearchLine lines[SEARCH_MAX_LINES];
+    size_t num_lines;
+} SearchResult;
+
+/*
+ * Structure representing a legal move of the root position, along with its
+ * score in the last iteration, used for ordering the root moves of the next
+ * one.
+ */
+typedef struct SearchRootMove {
+    Move move;
+    int score;
+} SearchRootMove;
+
+/*
+ * Structure representing the state of a multi-PV search of a position. The
+ * search uses its own copy of the board, so it can run in a separate thread.
+ */
+typedef struct Search {
+    Board board;
+
+    /* Number of lines that should be found, up to 'SEARCH_MAX_LINES' */
+    size_t num_lines;
+
+    /*
+     * Legal moves of the root position. All lines share this list, so each
+     * root move is only searched once per iteration, no matter the number of
+     * lines.
+     */
+    SearchRootMove root_moves[MOVELIST_MAX];
+    size_t num_root_moves;
+
+    /* Optional time manager for stopping the search, or NULL */
+    TimeManager* timeman;
+
+    /* Set by 'search_stop', possibly from another thread */
+    int stop_requested;
+    bool stopped;
+
+    uint64_t nodes;
+
+    /* Triangular table with the principal variation of each ply */
+    Move pv[SEARCH_MAX_PLY][SEARCH_MAX_PLY];
+    size_t pv_length[SEARCH_MAX_PLY];
+} Search;
+
+/*----------------------------------------------------------------------------*/
+
+/*
+ * Initialize a search of the position of the specified board, which is copied,
+ * for finding the specified number of lines. After successfuly calling this
+ * function, the caller is responsible for deinitializing it with
+ * 'search_destroy'.
+ *
+ * This function returns true on success, or false on error.
+ */
+bool search_init(Search* search, const Board* board, size_t num_lines);
+
+/*
+ * Deinitialize a 'Search' structure. It doesn't free the argument pointer
+ * itself.
+ */
+void search_destroy(Search* search);
+
+/*
+ * Search the position to the specified depth, storing the lines in 'dst'. The
+ * depths should be searched in increasing order (iterative deepening), since
+ * the root moves are ordered by the scores of the previous iteration.
+ *
+ * This function returns true if the iteration was completed, or false if the
+ * search was stopped, in which case 'dst' is not modified.
+ */
+bool search_iterate(Search* search, int depth, SearchResult* dst);
+
+/*
+ * Function called by 'search_run' after each completed iteration, with the
+ * result of the iteration and the 'data' argument of 'search_run'.
+ */
+typedef void (*SearchIterationCallback)(const SearchResult* result,
+                                        void* data);
+
+/*
+ * Search the position with iterative deepening, up to the specified maximum
+ * depth, storing the result of the last completed iteration in 'dst'.
+ *
+ * If 'timeman' is not NULL, the search is aborted at its hard deadline, and no
+ * new iterations are started once 'timeman_should_deepen' returns false. The
+ * optional 'callback' is called after each completed iteration.
+ *
+ * This function returns true if at least one iteration was completed.
+ */
+bool search_run(Search* search, TimeManager* timeman, int max_depth,
+                SearchResult* dst, SearchIterationCallback callback,
+                void* data);
+
+/*
+ * Request the search to stop as soon as possible. This function can be called
+ * from a different thread than the one running the search.
+ */
+void search_stop(Search* search);
+
+/*
+ * Check if the specified score represents a forced mate.
+ */
+static inline bool search_is_mate_score(int score) {
+    return score >= SEARCH_SCORE_MATE - SEARCH_MAX_PLY ||
+           score <= -SEARCH_SCORE_MATE + SEARCH_MAX_PLY;
+}
+
+#endif /* SEARCH_H_ */
@@ -0,0 +1,175 @@
+/*
+ * Copyright 2025 8dcc
+ *
+ * This file is part of 8dcc's Chess.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+/*
+ * Template of the recursive search functions of "search.c", which is included
+ * once for each variant, with 'SEARCH_VARIANT' defined as the name of the
+ * variant in 'VARIANT_LIST'. The calls to the rules of the variant are resolved
+ * at compile time, so standard chess doesn't pay for the rules of the other
+ * variants. This file has no include guard on purpose, and it should only be
+ * included from "search.c".
+ */
+
+#ifndef SEARCH_VARIANT
+#error "SEARCH_VARIANT should be defined before including this file"
+#endif
+
+#define SEARCH_CONCAT_(A, B) A##_##B
+#define SEARCH_CONCAT(A, B)  SEARCH_CONCAT_(A, B)
+
+#define QUIESCENCE SEARCH_CONCAT(quiescence, SEARCH_VARIANT)
+#define NEGAMAX    SEARCH_CONCAT(negamax, SEARCH_VARIANT)
+#define IS_LOST    SEARCH_CONCAT(rules_is_lost, SEARCH_VARIANT)
+
+/*
+ * Marker of the instantiation for this variant, checked in "search.c" against
+ * 'VARIANT_LIST'.
+ */
+enum { SEARCH_CONCAT(search_instantiated, SEARCH_VARIANT) = 1 };
+
+/*
+ * Search only the captures and promotions of the position, until it's quiet,
+ * so the static evaluation is not used in the middle of an exchange.
+ */
+static int QUIESCENCE(Search* search, size_t ply, int alpha, int beta) {
+    Board* board = &search->board;
+
+    search->pv_length[ply] = 0;
+    search->nodes++;
+    if (should_stop(search))
+        return 0;
+
+    if (IS_LOST(board))
+        return -SEARCH_SCORE_MATE + (int)ply;
+
+    /* The player in turn can usually avoid the captures (stand pat) */
+    PROFILE_BEGIN(PROFILE_SPAN_EVAL);
+    const int stand_pat = eval_relative(board);
+    PROFILE_END(PROFILE_SPAN_EVAL);
+    if (ply >= SEARCH_MAX_PLY - 1 || stand_pat >= beta)
+        return stand_pat;
+    if (stand_pat > alpha)
+        alpha = stand_pat;
+
+    MoveList list;
+    move_generate_pseudo_legal(board, &list);
+
+    int scores[MOVELIST_MAX];
+    for (size_t i = 0; i < list.count; i++)
+        scores[i] = order_score(board, &list.moves[i]);
+
+    const enum EPieceColor color = board->turn;
+    for (size_t i = 0; i < list.count; i++) {
+        pick_next_move(&list, scores, i);
+        if (scores[i] < ORDER_TACTICAL_BONUS)
+            break;
+
+        const Move* move = &list.moves[i];
+        MoveUndo undo;
+        move_make(board, move, &undo);
+        if (move_in_check(board, color)) {
+            move_unmake(board, move, &undo);
+            continue;
+        }
+        const int score = -QUIESCENCE(search, ply + 1, -beta, -alpha);
+        move_unmake(board, move, &undo);
+
+        if (search->stopped)
+            return 0;
+
+        if (score >= beta)
+            return beta;
+
+        if (score > alpha) {
+            alpha = score;
+            update_pv(search, ply, move);
+        }
+    }
+
+    return alpha;
+}
+
+/*
+ * Search the position to the specified depth with the alpha-beta algorithm, in
+ * its negamax form, returning its score for the player in turn.
+ */
+static int NEGAMAX(Search* search, int depth, size_t ply, int alpha,
+                   int beta) {
+    Board* board = &search->board;
+
+    if (depth <= 0 || ply >= SEARCH_MAX_PLY - 1)
+        return QUIESCENCE(search, ply, alpha, beta);
+
+    search->pv_length[ply] = 0;
+    search->nodes++;
+    if (should_stop(search))
+        return 0;
+
+    if (IS_LOST(board))
+        return -SEARCH_SCORE_MATE + (int)ply;
+
+    if (board->halfmove_clock >= FIFTY_MOVE_PLIES)
+        return 0;
+
+    MoveList list;
+    move_generate_pseudo_legal(board, &list);
+
+    int scores[MOVELIST_MAX];
+    for (size_t i = 0; i < list.count; i++)
+        scores[i] = order_score(board, &list.moves[i]);
+
+    const enum EPieceColor color = board->turn;
+    size_t num_legal             = 0;
+    for (size_t i = 0; i < list.count; i++) {
+        pick_next_move(&list, scores, i);
+
+        const Move* move = &list.moves[i];
+        MoveUndo undo;
+        move_make(board, move, &undo);
+        if (move_in_check(board, color)) {
+            move_unmake(board, move, &undo);
+            continue;
+        }
+        num_legal++;
+        const int score = -NEGAMAX(search, depth - 1, ply + 1, -beta, -alpha);
+        move_unmake(board, move, &undo);
+
+        if (search->stopped)
+            return 0;
+
+        if (score >= beta)
+            return beta;
+
+        if (score > alpha) {
+            alpha = score;
+            update_pv(search, ply, move);
+        }
+    }
+
+    /* Checkmate or stalemate, preferring the shortest mates */
+    if (num_legal == 0)
+        return move_in_check(board, color) ? -SEARCH_SCORE_MATE + (int)ply : 0;
+
+    return alpha;
+}
+
+#undef SEARCH_CONCAT_
+#undef SEARCH_CONCAT
+#undef QUIESCENCE
+#undef NEGAMAX
+#undef IS_LOST
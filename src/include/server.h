@@ -0,0 +1,58 @@
+/*
+ * Copyright 2025 8dcc
+ *
+ * This file is part of 8dcc's Chess.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef SERVER_H_
+#define SERVER_H_ 1
+
+#include <stdbool.h>
+#include <stdint.h>
+
+/*
+ * Run a server that hosts chess games over TCP on the specified port, until the
+ * process is interrupted. All connections are handled by a single thread with
+ * 'epoll'.
+ *
+ * The protocol is line-based. Each client can send the following commands:
+ *
+ *   new             Create a new game, playing as white.
+ *   join ID         Join the game with the specified ID, playing as black.
+ *   move MOVE       Make a move in coordinate notation (e.g. "e2e4").
+ *   fen             Request the current position in FEN.
+ *   leave           Leave the current game, resigning it if it's not over.
+ *   quit            Close the connection, leaving the current game.
+ *
+ * The server replies with the following messages:
+ *
+ *   game ID COLOR   The client is playing in game ID with the specified color.
+ *   joined          The opponent joined the game.
+ *   left            The opponent left the game, which ended.
+ *   move MOVE       A move was made by one of the players.
+ *   cell CELL PIECE A cell changed after the last move. The piece is in FEN
+ *                   notation, or '-' for empty cells.
+ *   fen FEN         The current position, in reply to 'fen'.
+ *   end REASON      The game ended ("checkmate" or "stalemate").
+ *   error REASON    The last command was not valid.
+ *
+ * Once a game ends, both players can create or join another one. The IDs of
+ * finished games are reused for new games.
+ *
+ * This function only returns on error, after printing a message.
+ */
+bool server_run(uint16_t port);
+
+#endif /* SERVER_H_ */
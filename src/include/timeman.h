@@ -0,0 +1,123 @@
+/*
+ * Copyright 2025 8dcc
+ *
+ * This file is part of 8dcc's Chess.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef TIMEMAN_H_
+#define TIMEMAN_H_ 1
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "clock.h"
+#include "piece.h"
+
+/*
+ * Number of nodes searched between each check of the hard deadline. Must be a
+ * power of two, since it's used as a mask in 'timeman_check_nodes'.
+ */
+#define TIMEMAN_CHECK_INTERVAL 4096
+
+/*
+ * Number of consecutive iterations with the same best move after which the
+ * search is considered stable, and can be stopped before the soft deadline.
+ */
+#define TIMEMAN_STABLE_ITERATIONS 4
+
+/*
+ * Structure used by the engine for managing the time of a single move.
+ *
+ * The soft deadline is checked after each iterative deepening iteration, and
+ * the engine shouldn't start a new iteration after it. The hard deadline is
+ * checked periodically while searching, and the search must be aborted after
+ * it, even if the current iteration is not complete.
+ */
+typedef struct TimeManager {
+    /* Monotonic time when the search started, in milliseconds */
+    int64_t start_ms;
+
+    /* Deadlines relative to 'start_ms', in milliseconds */
+    int64_t soft_ms;
+    int64_t hard_ms;
+
+    /* Number of consecutive iterations without changes in the best move */
+    int stability;
+
+    /*
+     * True if the search can stop before the soft deadline when the best move
+     * is stable, see 'timeman_should_deepen'.
+     */
+    bool stop_when_stable;
+
+    /* True if the hard deadline was reached during the search */
+    bool stopped;
+} TimeManager;
+
+/*----------------------------------------------------------------------------*/
+
+/*
+ * Initialize a 'TimeManager' structure for a search of the specified color,
+ * calculating the soft and hard deadlines from its remaining time in the
+ * specified clock.
+ */
+void timeman_init(TimeManager* timeman, const GameClock* clock,
+                  enum EPieceColor color);
+
+/*
+ * Initialize a 'TimeManager' structure for a search with a fixed time, in
+ * milliseconds. Both deadlines will be the same, and the search never stops
+ * early because of a stable best move, so the whole time is used.
+ */
+void timeman_init_fixed(TimeManager* timeman, int64_t move_ms);
+
+/*
+ * Return the number of milliseconds elapsed since the search started.
+ */
+int64_t timeman_elapsed_ms(const TimeManager* timeman);
+
+/*
+ * Check if the hard deadline was reached, updating the 'stopped' member. This
+ * function reads the system clock, so it's usually called through
+ * 'timeman_check_nodes'.
+ */
+bool timeman_check_hard(TimeManager* timeman);
+
+/*
+ * Check if a new iterative deepening iteration should be started, after one
+ * was completed. The 'best_move_changed' argument indicates whether the best
+ * move of the completed iteration is different from the previous one.
+ *
+ * The search is stopped after the soft deadline, or earlier if the best move
+ * has been stable for a number of iterations (unless it's a fixed-time search).
+ */
+bool timeman_should_deepen(TimeManager* timeman, bool best_move_changed);
+
+/*
+ * Check if the search should be aborted after searching the specified number of
+ * nodes. The system clock is only read every 'TIMEMAN_CHECK_INTERVAL' nodes, so
+ * this function can be called from every node of the search.
+ */
+static inline bool timeman_check_nodes(TimeManager* timeman, uint64_t nodes) {
+    if (timeman->stopped)
+        return true;
+
+    if ((nodes & (TIMEMAN_CHECK_INTERVAL - 1)) != 0)
+        return false;
+
+    return timeman_check_hard(timeman);
+}
+
+#endif /* TIMEMAN_H_ */
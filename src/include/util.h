@@ -29,4 +29,11 @@
  */
 #define STRLEN(STR) (ARRLEN(STR) - 1)
 
+/*
+ * Return the minimum or maximum of two values. The arguments are evaluated
+ * more than once.
+ */
+#define MIN(A, B) (((A) < (B)) ? (A) : (B))
+#define MAX(A, B) (((A) > (B)) ? (A) : (B))
+
 #endif /* UTIL_H_ */
@@ -0,0 +1,58 @@
+/*
+ * Copyright 2025 8dcc
+ *
+ * This file is part of 8dcc's Chess.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#ifndef VARIANT_H_
+#define VARIANT_H_ 1
+
+#include <stdbool.h>
+
+/*
+ * Enumeration with the supported chess variants. Chess960 is not a separate
+ * variant, since it only changes the initial position, and castling is always
+ * generalized to arbitrary rook columns.
+ */
+enum EVariant {
+    VARIANT_STANDARD,
+    VARIANT_KING_OF_THE_HILL,
+};
+
+/*
+ * List with the name and the enumeration value of each variant, for
+ * instantiating the code that depends on the rules once per variant (see
+ * "rules.h"). The specified macro is called with each pair, for example:
+ *
+ *     #define DEFINE_FOO(NAME, VARIANT) \
+ *         static void foo_##NAME(Board* board) { ... }
+ *     VARIANT_LIST(DEFINE_FOO)
+ *
+ * The search is instantiated by including a template once per variant, so a
+ * new variant also needs a new instantiation in "search.c".
+ */
+#define VARIANT_LIST(MACRO)                                                    \
+    MACRO(standard, VARIANT_STANDARD)                                          \
+    MACRO(king_of_the_hill, VARIANT_KING_OF_THE_HILL)
+
+/*----------------------------------------------------------------------------*/
+
+/*
+ * Parse the name of a variant (e.g. "standard" or "koth"), and store it in
+ * 'dst'. Returns false if the name is not valid.
+ */
+bool variant_from_str(const char* str, enum EVariant* dst);
+
+#endif /* VARIANT_H_ */
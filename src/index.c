@@ -0,0 +1,701 @@
+/*
+ * Copyright 2025 8dcc
+ *
+ * This file is part of 8dcc's Chess.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#define _POSIX_C_SOURCE 200809L /* mmap */
+
+#include <errno.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "include/index.h"
+#include "include/board.h"
+#include "include/move.h"
+#include "include/profile.h"
+
+/*
+ * Magic bytes at the start of index files. Changed whenever the format or the
+ * hashes of the positions change, so old files are rejected.
+ */
+#define INDEX_MAGIC "CHSIDX02"
+
+/*
+ * Initial number of slots in the hash table of each thread, unless its share of
+ * the memory limit is lower. Must be a power of two.
+ */
+#define TABLE_INITIAL_CAPACITY 4096
+
+/*
+ * Minimum number of slots in the hash table of each thread, even if its share
+ * of the memory limit is lower. Must be a power of two.
+ */
+#define TABLE_MIN_CAPACITY 16
+
+/*
+ * Maximum length of a single token of the games file.
+ */
+#define MAX_TOKEN_LEN 16
+
+/*
+ * Maximum path length of the temporary run files.
+ */
+#define MAX_RUN_PATH_LEN 4096
+
+/*
+ * Header of the index files, followed by 'count' entries sorted by hash.
+ */
+typedef struct IndexHeader {
+    char magic[8];
+    uint64_t count;
+} IndexHeader;
+
+/*
+ * Possible results of a game.
+ */
+enum EGameResult {
+    GAME_RESULT_NONE,
+    GAME_RESULT_WHITE,
+    GAME_RESULT_DRAW,
+    GAME_RESULT_BLACK,
+};
+
+/*
+ * Structure with the state of each thread used for building the index.
+ */
+typedef struct IndexWorker {
+    int id;
+    const char* output_path;
+
+    /* Range of the games file processed by this thread */
+    const char* begin;
+    const char* end;
+
+    /*
+     * Open-addressing hash table with linear probing. Empty slots have no
+     * games. The capacity is always a power of two.
+     */
+    IndexEntry* table;
+    size_t capacity;
+    size_t count;
+    size_t max_capacity;
+
+    /* Hashes of the positions of the current game */
+    uint64_t* game_hashes;
+    size_t game_hashes_size;
+    size_t game_hashes_capacity;
+
+    /* Number of sorted runs written to disk */
+    int num_runs;
+
+    /* Statistics, and whether the thread succeeded */
+    uint64_t num_games;
+    uint64_t num_positions;
+    bool ok;
+} IndexWorker;
+
+/*----------------------------------------------------------------------------*/
+
+/*
+ * Write the path of the specified temporary run to 'dst'.
+ */
+static void get_run_path(char* dst, const char* output_path, int worker_id,
+                         int run) {
+    snprintf(dst,
+             MAX_RUN_PATH_LEN,
+             "%s.run%d.%d",
+             output_path,
+             worker_id,
+             run);
+}
+
+/*
+ * Compare two hashes, for 'qsort'.
+ */
+static int compare_hashes(const void* a, const void* b) {
+    const uint64_t hash_a = *(const uint64_t*)a;
+    const uint64_t hash_b = *(const uint64_t*)b;
+    return (hash_a > hash_b) - (hash_a < hash_b);
+}
+
+/*
+ * Compare two entries by hash, for 'qsort'.
+ */
+static int compare_entries(const void* a, const void* b) {
+    const uint64_t hash_a = ((const IndexEntry*)a)->hash;
+    const uint64_t hash_b = ((const IndexEntry*)b)->hash;
+    return (hash_a > hash_b) - (hash_a < hash_b);
+}
+
+/*
+ * Check if a slot of a hash table is empty.
+ */
+static inline bool is_slot_empty(const IndexEntry* entry) {
+    return index_entry_games(entry) == 0;
+}
+
+/*
+ * Return the slot of the specified hash in the table of a worker, which might
+ * be empty.
+ */
+static inline IndexEntry* find_slot(IndexEntry* table, size_t capacity,
+                                    uint64_t hash) {
+    size_t i = hash & (capacity - 1);
+    while (!is_slot_empty(&table[i]) && table[i].hash != hash)
+        i = (i + 1) & (capacity - 1);
+
+    return &table[i];
+}
+
+/*
+ * Write the entries of the hash table of a worker to a new sorted run file,
+ * and clear the table.
+ */
+static bool spill_table(IndexWorker* worker) {
+    /* Move all entries to the start of the table, and sort them */
+    size_t count = 0;
+    for (size_t i = 0; i < worker->capacity; i++)
+        if (!is_slot_empty(&worker->table[i]))
+            worker->table[count++] = worker->table[i];
+    qsort(worker->table, count, sizeof(IndexEntry), compare_entries);
+
+    char path[MAX_RUN_PATH_LEN];
+    get_run_path(path, worker->output_path, worker->id, worker->num_runs);
+
+    FILE* fp = fopen(path, "wb");
+    if (fp == NULL) {
+        fprintf(stderr, "Failed to create '%s': %s\n", path, strerror(errno));
+        return false;
+    }
+
+    const bool result =
+      fwrite(worker->table, sizeof(IndexEntry), count, fp) == count;
+    if (fclose(fp) != 0 || !result) {
+        fprintf(stderr, "Failed to write '%s'.\n", path);
+        return false;
+    }
+
+    worker->num_runs++;
+    worker->count = 0;
+    memset(worker->table, 0, worker->capacity * sizeof(IndexEntry));
+    return true;
+}
+
+/*
+ * Double the capacity of the hash table of a worker, rehashing all entries.
+ */
+static bool grow_table(IndexWorker* worker) {
+    const size_t new_capacity = worker->capacity * 2;
+    IndexEntry* new_table     = calloc(new_capacity, sizeof(IndexEntry));
+    if (new_table == NULL)
+        return false;
+
+    for (size_t i = 0; i < worker->capacity; i++)
+        if (!is_slot_empty(&worker->table[i]))
+            *find_slot(new_table, new_capacity, worker->table[i].hash) =
+              worker->table[i];
+
+    free(worker->table);
+    worker->table    = new_table;
+    worker->capacity = new_capacity;
+    return true;
+}
+
+/*
+ * Add a game result to the entry of the specified hash in the table of a
+ * worker. When the table is too full, it grows, or it's spilled to disk if
+ * that would exceed the memory limit.
+ */
+static bool insert_position(IndexWorker* worker, uint64_t hash,
+                            enum EGameResult result) {
+    PROFILE_BEGIN(PROFILE_SPAN_INDEX_INSERT);
+
+    /* Keep the load factor under 70% */
+    bool ok = true;
+    if ((worker->count + 1) * 10 > worker->capacity * 7) {
+        if (worker->capacity * 2 <= worker->max_capacity)
+            ok = grow_table(worker) || spill_table(worker);
+        else
+            ok = spill_table(worker);
+    }
+
+    if (ok) {
+        IndexEntry* entry = find_slot(worker->table, worker->capacity, hash);
+        if (is_slot_empty(entry)) {
+            entry->hash = hash;
+            worker->count++;
+        }
+
+        /* clang-format off */
+        switch (result) {
+            case GAME_RESULT_WHITE: entry->white_wins++; break;
+            case GAME_RESULT_DRAW:  entry->draws++;      break;
+            case GAME_RESULT_BLACK: entry->black_wins++; break;
+            case GAME_RESULT_NONE:                       break;
+        }
+        /* clang-format on */
+    }
+
+    PROFILE_END(PROFILE_SPAN_INDEX_INSERT);
+    return ok;
+}
+
+/*
+ * Store the hash of the current position of the game being replayed by a
+ * worker.
+ */
+static bool push_game_hash(IndexWorker* worker, uint64_t hash) {
+    if (worker->game_hashes_size >= worker->game_hashes_capacity) {
+        const size_t new_capacity = worker->game_hashes_capacity * 2;
+        uint64_t* new_hashes =
+          realloc(worker->game_hashes, new_capacity * sizeof(uint64_t));
+        if (new_hashes == NULL)
+            return false;
+        worker->game_hashes          = new_hashes;
+        worker->game_hashes_capacity = new_capacity;
+    }
+
+    worker->game_hashes[worker->game_hashes_size++] = hash;
+    return true;
+}
+
+/*
+ * Return the game result represented by the specified token, or
+ * 'GAME_RESULT_NONE' if it's not a result.
+ */
+static enum EGameResult parse_result(const char* token) {
+    if (strcmp(token, "1-0") == 0)
+        return GAME_RESULT_WHITE;
+    if (strcmp(token, "0-1") == 0)
+        return GAME_RESULT_BLACK;
+    if (strcmp(token, "1/2-1/2") == 0)
+        return GAME_RESULT_DRAW;
+
+    return GAME_RESULT_NONE;
+}
+
+/*
+ * Replay the game in the specified line, and add all of its positions to the
+ * table of the worker. Returns false on fatal errors; invalid games are
+ * ignored.
+ */
+static bool process_game(IndexWorker* worker, Board* board, const char* line,
+                         const char* line_end) {
+    board_set_initial_layout(board);
+    worker->game_hashes_size = 0;
+    if (!push_game_hash(worker, board->hash))
+        return false;
+
+    enum EGameResult result = GAME_RESULT_NONE;
+
+    const char* p = line;
+    while (p < line_end) {
+        /* Read the next token into a null-terminated buffer */
+        while (p < line_end && (*p == ' ' || *p == '\t' || *p == '\r'))
+            p++;
+        const char* token_start = p;
+        while (p < line_end && *p != ' ' && *p != '\t' && *p != '\r')
+            p++;
+
+        const size_t token_len = p - token_start;
+        if (token_len == 0)
+            break;
+        if (token_len >= MAX_TOKEN_LEN)
+            return true;
+
+        char token[MAX_TOKEN_LEN];
+        memcpy(token, token_start, token_len);
+        token[token_len] = '\0';
+
+        /* Move numbers */
+        if (token[token_len - 1] == '.')
+            continue;
+
+        result = parse_result(token);
+        if (result != GAME_RESULT_NONE)
+            break;
+
+        Move move;
+        if (!move_from_str(board, token, &move))
+            return true;
+
+        MoveUndo undo;
+        move_make(board, &move, &undo);
+        if (!push_game_hash(worker, board->hash))
+            return false;
+    }
+
+    if (result == GAME_RESULT_NONE)
+        return true;
+
+    /* Positions repeated in the same game are only counted once */
+    qsort(worker->game_hashes,
+          worker->game_hashes_size,
+          sizeof(uint64_t),
+          compare_hashes);
+    size_t num_unique = 0;
+    for (size_t i = 0; i < worker->game_hashes_size; i++)
+        if (num_unique == 0 ||
+            worker->game_hashes[i] != worker->game_hashes[num_unique - 1])
+            worker->game_hashes[num_unique++] = worker->game_hashes[i];
+    worker->game_hashes_size = num_unique;
+
+    for (size_t i = 0; i < worker->game_hashes_size; i++)
+        if (!insert_position(worker, worker->game_hashes[i], result))
+            return false;
+
+    worker->num_games++;
+    worker->num_positions += worker->game_hashes_size;
+    return true;
+}
+
+/*
+ * Entry point of each thread used for building the index.
+ */
+static void* worker_main(void* arg) {
+    IndexWorker* worker = arg;
+    worker->ok          = false;
+
+    Board board;
+    if (!board_init(&board, 8, 8))
+        return NULL;
+
+    const char* line = worker->begin;
+    while (line < worker->end) {
+        const char* line_end = memchr(line, '\n', worker->end - line);
+        if (line_end == NULL)
+            line_end = worker->end;
+
+        if (!process_game(worker, &board, line, line_end)) {
+            board_destroy(&board);
+            return NULL;
+        }
+
+        line = line_end + 1;
+    }
+
+    board_destroy(&board);
+
+    if (worker->count > 0 && !spill_table(worker))
+        return NULL;
+
+    profile_merge_thread();
+    worker->ok = true;
+    return NULL;
+}
+
+/*----------------------------------------------------------------------------*/
+
+/*
+ * Structure representing a sorted run being merged.
+ */
+typedef struct RunReader {
+    FILE* fp;
+    IndexEntry current;
+    bool has_current;
+} RunReader;
+
+/*
+ * Read the next entry of the specified run.
+ */
+static inline void run_advance(RunReader* run) {
+    run->has_current =
+      (fread(&run->current, sizeof(IndexEntry), 1, run->fp) == 1);
+}
+
+/*
+ * Merge the sorted runs of all workers into the final index file, adding the
+ * counters of the entries with the same hash. The runs are removed afterwards.
+ */
+static bool merge_runs(IndexWorker* workers, int num_workers,
+                       const char* output_path) {
+    int num_runs = 0;
+    for (int i = 0; i < num_workers; i++)
+        num_runs += workers[i].num_runs;
+
+    RunReader* runs = calloc(num_runs > 0 ? num_runs : 1, sizeof(RunReader));
+    if (runs == NULL)
+        return false;
+
+    bool result = true;
+    char path[MAX_RUN_PATH_LEN];
+
+    int run_idx = 0;
+    for (int i = 0; i < num_workers; i++) {
+        for (int j = 0; j < workers[i].num_runs; j++) {
+            get_run_path(path, output_path, i, j);
+            runs[run_idx].fp = fopen(path, "rb");
+            if (runs[run_idx].fp == NULL) {
+                fprintf(stderr, "Failed to open '%s'.\n", path);
+                result = false;
+            } else {
+                run_advance(&runs[run_idx]);
+            }
+            run_idx++;
+        }
+    }
+
+    FILE* output = result ? fopen(output_path, "wb") : NULL;
+
+    IndexHeader header;
+    memcpy(header.magic, INDEX_MAGIC, sizeof(header.magic));
+    header.count = 0;
+
+    if (output == NULL || fwrite(&header, sizeof(header), 1, output) != 1) {
+        fprintf(stderr, "Failed to create '%s'.\n", output_path);
+        result = false;
+    }
+
+    while (result) {
+        /* Find the smallest hash of all runs */
+        RunReader* min = NULL;
+        for (int i = 0; i < num_runs; i++)
+            if (runs[i].has_current &&
+                (min == NULL || runs[i].current.hash < min->current.hash))
+                min = &runs[i];
+        if (min == NULL)
+            break;
+
+        /* Add the counters of all runs with that hash */
+        IndexEntry entry = min->current;
+        run_advance(min);
+        for (int i = 0; i < num_runs; i++) {
+            while (runs[i].has_current && runs[i].current.hash == entry.hash) {
+                entry.white_wins += runs[i].current.white_wins;
+                entry.draws += runs[i].current.draws;
+                entry.black_wins += runs[i].current.black_wins;
+                run_advance(&runs[i]);
+            }
+        }
+
+        if (fwrite(&entry, sizeof(entry), 1, output) != 1) {
+            fprintf(stderr, "Failed to write '%s'.\n", output_path);
+            result = false;
+        }
+        header.count++;
+    }
+
+    /* Write the final number of entries */
+    if (result && (fseek(output, 0, SEEK_SET) != 0 ||
+                   fwrite(&header, sizeof(header), 1, output) != 1)) {
+        fprintf(stderr, "Failed to write '%s'.\n", output_path);
+        result = false;
+    }
+    if (output != NULL && fclose(output) != 0)
+        result = false;
+
+    run_idx = 0;
+    for (int i = 0; i < num_workers; i++) {
+        for (int j = 0; j < workers[i].num_runs; j++) {
+            if (runs[run_idx].fp != NULL)
+                fclose(runs[run_idx].fp);
+            get_run_path(path, output_path, i, j);
+            remove(path);
+            run_idx++;
+        }
+    }
+
+    free(runs);
+    return result;
+}
+
+/*----------------------------------------------------------------------------*/
+
+bool index_build(const char* games_path, const char* output_path,
+                 int num_threads, size_t memory_limit) {
+    const int fd = open(games_path, O_RDONLY);
+    if (fd < 0) {
+        fprintf(stderr,
+                "Failed to open '%s': %s\n",
+                games_path,
+                strerror(errno));
+        return false;
+    }
+
+    struct stat st;
+    if (fstat(fd, &st) < 0 || st.st_size == 0) {
+        fprintf(stderr, "Failed to read '%s'.\n", games_path);
+        close(fd);
+        return false;
+    }
+
+    const size_t size = st.st_size;
+    const char* data  = mmap(NULL, size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (data == MAP_FAILED) {
+        fprintf(stderr, "Failed to map '%s'.\n", games_path);
+        return false;
+    }
+
+    /* Ensure the global hash keys are initialized before starting threads */
+    Board board;
+    if (!board_init(&board, 8, 8)) {
+        munmap((void*)data, size);
+        return false;
+    }
+    board_destroy(&board);
+
+    IndexWorker* workers = calloc(num_threads, sizeof(IndexWorker));
+    pthread_t* threads   = calloc(num_threads, sizeof(pthread_t));
+    if (workers == NULL || threads == NULL) {
+        free(workers);
+        free(threads);
+        munmap((void*)data, size);
+        return false;
+    }
+
+    /* Maximum number of table slots of each thread, as a power of two */
+    size_t max_capacity = TABLE_MIN_CAPACITY;
+    while (max_capacity * 2 * sizeof(IndexEntry) <= memory_limit / num_threads)
+        max_capacity *= 2;
+
+    /* Tables start small, unless the memory limit is even smaller */
+    const size_t initial_capacity = (max_capacity < TABLE_INITIAL_CAPACITY)
+                                      ? max_capacity
+                                      : TABLE_INITIAL_CAPACITY;
+
+    /* Split the file in contiguous ranges, ending at line boundaries */
+    const char* range_start = data;
+    for (int i = 0; i < num_threads; i++) {
+        const char* range_end = (i == num_threads - 1)
+                                  ? data + size
+                                  : data + size * (i + 1) / num_threads;
+        if (range_end < range_start)
+            range_end = range_start;
+        while (range_end > data && range_end < data + size &&
+               range_end[-1] != '\n')
+            range_end++;
+
+        IndexWorker* worker          = &workers[i];
+        worker->id                   = i;
+        worker->output_path          = output_path;
+        worker->begin                = range_start;
+        worker->end                  = range_end;
+        worker->capacity             = initial_capacity;
+        worker->max_capacity         = max_capacity;
+        worker->table                = calloc(worker->capacity,
+                                              sizeof(IndexEntry));
+        worker->game_hashes_capacity = 256;
+        worker->game_hashes =
+          malloc(worker->game_hashes_capacity * sizeof(uint64_t));
+
+        range_start = range_end;
+    }
+
+    int num_started = 0;
+    for (int i = 0; i < num_threads; i++) {
+        if (workers[i].table == NULL || workers[i].game_hashes == NULL ||
+            pthread_create(&threads[i], NULL, worker_main, &workers[i]) != 0)
+            break;
+        num_started++;
+    }
+
+    bool result = (num_started == num_threads);
+    for (int i = 0; i < num_started; i++) {
+        pthread_join(threads[i], NULL);
+        result = result && workers[i].ok;
+    }
+
+    uint64_t num_games = 0, num_positions = 0;
+    for (int i = 0; i < num_threads; i++) {
+        num_games += workers[i].num_games;
+        num_positions += workers[i].num_positions;
+        free(workers[i].table);
+        free(workers[i].game_hashes);
+    }
+
+    if (result)
+        result = merge_runs(workers, num_threads, output_path);
+
+    if (result)
+        printf("Indexed %llu positions of %llu games.\n",
+               (unsigned long long)num_positions,
+               (unsigned long long)num_games);
+
+    free(workers);
+    free(threads);
+    munmap((void*)data, size);
+    return result;
+}
+
+bool index_open(Index* index, const char* path) {
+    const int fd = open(path, O_RDONLY);
+    if (fd < 0)
+        return false;
+
+    struct stat st;
+    if (fstat(fd, &st) < 0 || (size_t)st.st_size < sizeof(IndexHeader)) {
+        close(fd);
+        return false;
+    }
+
+    void* mapping = mmap(NULL, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    close(fd);
+    if (mapping == MAP_FAILED)
+        return false;
+
+    const IndexHeader* header = mapping;
+    if (memcmp(header->magic, INDEX_MAGIC, sizeof(header->magic)) != 0 ||
+        header->count >
+          (st.st_size - sizeof(IndexHeader)) / sizeof(IndexEntry)) {
+        munmap(mapping, st.st_size);
+        return false;
+    }
+
+    index->mapping      = mapping;
+    index->mapping_size = st.st_size;
+    index->entries      = (const IndexEntry*)(header + 1);
+    index->count        = header->count;
+    return true;
+}
+
+void index_close(Index* index) {
+    if (index->mapping != NULL) {
+        munmap(index->mapping, index->mapping_size);
+        index->mapping = NULL;
+    }
+}
+
+const IndexEntry* index_probe(const Index* index, uint64_t hash) {
+    PROFILE_BEGIN(PROFILE_SPAN_INDEX_PROBE);
+
+    /* Binary search, the entries are sorted by hash */
+    const IndexEntry* result = NULL;
+    size_t lo = 0, hi = index->count;
+    while (lo < hi) {
+        const size_t mid = lo + (hi - lo) / 2;
+        if (index->entries[mid].hash < hash) {
+            lo = mid + 1;
+        } else if (index->entries[mid].hash > hash) {
+            hi = mid;
+        } else {
+            result = &index->entries[mid];
+            break;
+        }
+    }
+
+    PROFILE_END(PROFILE_SPAN_INDEX_PROBE);
+    return result;
+}
@@ -23,6 +23,7 @@
 
 #include "include/input.h"
 #include "include/board.h"
+#include "include/move.h"
 
 /*
  * Key received by 'getch' when the user presses Ctrl+C.
@@ -44,7 +45,8 @@ static inline int get_user_char(void) {
 /*----------------------------------------------------------------------------*/
 
 enum EInputKey input_get_key(void) {
-    switch (tolower(get_user_char())) {
+    const int c = tolower(get_user_char());
+    switch (c) {
         case 'q':
         case KEY_CTRLC:
             return INPUT_KEY_QUIT;
@@ -69,6 +71,37 @@ enum EInputKey input_get_key(void) {
         case KEY_ENTER:
             return INPUT_KEY_SELECT;
 
+        case 'n':
+        case KEY_NPAGE:
+            return INPUT_KEY_NEXT;
+
+        case 'p':
+        case KEY_PPAGE:
+            return INPUT_KEY_PREV;
+
+        case '<':
+        case KEY_HOME:
+            return INPUT_KEY_FIRST;
+
+        case '>':
+        case KEY_END:
+            return INPUT_KEY_LAST;
+
+        case 'g':
+            return INPUT_KEY_GOTO;
+
+        case '0':
+        case '1':
+        case '2':
+        case '3':
+        case '4':
+        case '5':
+        case '6':
+        case '7':
+        case '8':
+        case '9':
+            return INPUT_KEY_DIGIT_0 + (c - '0');
+
         default:
             return INPUT_KEY_UNKNOWN;
     }
@@ -78,7 +111,8 @@ enum EInputKey input_get_key(void) {
  * TODO: Perhaps this function should be moved to a separate module, and keep
  * the processing outside of the 'input' module.
  */
-bool input_process_game_key(Board* board, enum EInputKey input_key) {
+bool input_process_game_key(Board* board, MoveCache* cache,
+                            enum EInputKey input_key) {
     switch (input_key) {
         case INPUT_KEY_UP:
             if (board->cursor.y > 0)
@@ -106,9 +140,21 @@ bool input_process_game_key(Board* board, enum EInputKey input_key) {
                 board->selection.x = board->cursor.x;
                 board->selection.y = board->cursor.y;
             } else {
+                /*
+                 * Selecting a second cell moves the selected piece there, if
+                 * it's a legal move. Either way, the selection is cleared.
+                 */
+                if (board->selection.x != board->cursor.x ||
+                    board->selection.y != board->cursor.y)
+                    move_make_legal(board,
+                                    cache,
+                                    board->selection,
+                                    board->cursor);
+
                 board->selection.x = BOARD_COL_NONE;
                 board->selection.y = BOARD_ROW_NONE;
             }
+            move_cache_update_selection(cache, board);
             break;
 
         default:
@@ -16,31 +16,228 @@
  * this program. If not, see <https://www.gnu.org/licenses/>.
  */
 
+#include <stdbool.h>
+#include <stdint.h>
 #include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
 
+#include "include/analysis.h"
 #include "include/board.h"
+#include "include/clock.h"
+#include "include/move.h"
+#include "include/profile.h"
 #include "include/render.h"
 #include "include/input.h"
+#include "include/server.h"
+#include "include/index.h"
+#include "include/replay.h"
+#include "include/search.h"
+#include "include/variant.h"
 
-int main(void) {
+/*
+ * Default number of threads and memory limit for building position indexes.
+ */
+#define DEFAULT_INDEX_THREADS   4
+#define DEFAULT_INDEX_MEMORY_MB 256
+
+static void print_usage(FILE* fp, const char* self) {
+    fprintf(fp,
+            "Usage: %s [OPTION]...\n"
+            "Options:\n"
+            "  --help                      Show this help and exit.\n"
+            "  --clock MIN[+INC][/MOVES]   Play with chess clocks.\n"
+            "  --stats                     Print profiling stats on exit.\n"
+            "  --serve PORT                Host network games on PORT.\n"
+            "  --index FILE                Show position stats from FILE.\n"
+            "  --build-index GAMES FILE    Build a position index of GAMES.\n"
+            "  --threads N                 Threads for building the index.\n"
+            "  --index-memory MB           Memory limit for building it.\n"
+            "  --replay FILE               Review the game in FILE.\n"
+            "  --analysis N                Show the best N lines.\n"
+            "  --chess960 N                Start from Chess960 position N.\n"
+            "  --variant NAME              Play a variant (standard, koth).\n",
+            self);
+}
+
+/*
+ * Parse a decimal integer in the specified range from a command-line argument.
+ * Returns false if the argument is not valid.
+ */
+static bool parse_long_arg(const char* str, long min, long max, long* dst) {
+    char* endptr;
+    const long value = strtol(str, &endptr, 10);
+    if (endptr == str || *endptr != '\0' || value < min || value > max) {
+        fprintf(stderr, "Invalid number '%s'.\n", str);
+        return false;
+    }
+
+    *dst = value;
+    return true;
+}
+
+int main(int argc, char** argv) {
     const size_t board_width  = 8;
     const size_t board_height = 8;
 
+    GameClock clock;
+    bool use_clock  = false;
+    bool show_stats = false;
+
+    long serve_port = 0;
+
+    const char* index_path        = NULL;
+    const char* build_games_path  = NULL;
+    const char* build_output_path = NULL;
+    long index_threads            = DEFAULT_INDEX_THREADS;
+    long index_memory_mb          = DEFAULT_INDEX_MEMORY_MB;
+
+    const char* replay_path = NULL;
+
+    long analysis_lines = 0;
+
+    long chess960_index   = -1;
+    enum EVariant variant = VARIANT_STANDARD;
+
+    for (int i = 1; i < argc; i++) {
+        if (strcmp(argv[i], "--help") == 0) {
+            print_usage(stdout, argv[0]);
+            return 0;
+        } else if (strcmp(argv[i], "--stats") == 0) {
+            show_stats = true;
+        } else if (strcmp(argv[i], "--serve") == 0 && i + 1 < argc) {
+            if (!parse_long_arg(argv[++i], 1, UINT16_MAX, &serve_port))
+                return 1;
+        } else if (strcmp(argv[i], "--index") == 0 && i + 1 < argc) {
+            index_path = argv[++i];
+        } else if (strcmp(argv[i], "--build-index") == 0 && i + 2 < argc) {
+            build_games_path  = argv[++i];
+            build_output_path = argv[++i];
+        } else if (strcmp(argv[i], "--threads") == 0 && i + 1 < argc) {
+            if (!parse_long_arg(argv[++i], 1, 256, &index_threads))
+                return 1;
+        } else if (strcmp(argv[i], "--index-memory") == 0 && i + 1 < argc) {
+            if (!parse_long_arg(argv[++i], 1, 1024 * 1024, &index_memory_mb))
+                return 1;
+        } else if (strcmp(argv[i], "--replay") == 0 && i + 1 < argc) {
+            replay_path = argv[++i];
+        } else if (strcmp(argv[i], "--analysis") == 0 && i + 1 < argc) {
+            if (!parse_long_arg(argv[++i],
+                                1,
+                                SEARCH_MAX_LINES,
+                                &analysis_lines))
+                return 1;
+        } else if (strcmp(argv[i], "--chess960") == 0 && i + 1 < argc) {
+            if (!parse_long_arg(argv[++i],
+                                0,
+                                BOARD_CHESS960_COUNT - 1,
+                                &chess960_index))
+                return 1;
+        } else if (strcmp(argv[i], "--variant") == 0 && i + 1 < argc) {
+            if (!variant_from_str(argv[++i], &variant)) {
+                fprintf(stderr, "Invalid variant '%s'.\n", argv[i]);
+                return 1;
+            }
+        } else if (strcmp(argv[i], "--clock") == 0 && i + 1 < argc) {
+            if (!clock_init_from_str(&clock, argv[++i])) {
+                fprintf(stderr,
+                        "Invalid time control '%s', expected format: "
+                        "MINUTES[+INCREMENT][/MOVES]\n",
+                        argv[i]);
+                return 1;
+            }
+            use_clock = true;
+        } else {
+            fprintf(stderr, "Invalid argument '%s'.\n", argv[i]);
+            print_usage(stderr, argv[0]);
+            return 1;
+        }
+    }
+
+    if (use_clock && replay_path != NULL) {
+        fprintf(stderr, "The clock can't be used when reviewing a game.\n");
+        return 1;
+    }
+
+    /* The server and the index builder don't use the terminal interface */
+    if (serve_port != 0)
+        return server_run(serve_port) ? 0 : 1;
+
+    if (build_games_path != NULL) {
+        profile_startup();
+        const bool built = index_build(build_games_path,
+                                       build_output_path,
+                                       index_threads,
+                                       (size_t)index_memory_mb * 1024 * 1024);
+        if (show_stats) {
+            profile_merge_thread();
+            profile_print_report(stdout);
+        }
+        return built ? 0 : 1;
+    }
+
+    Index index = { 0 };
+    if (index_path != NULL && !index_open(&index, index_path)) {
+        fprintf(stderr, "Failed to open index '%s'.\n", index_path);
+        return 1;
+    }
+
     Board board;
+    MoveCache move_cache;
     if (!board_init(&board, board_width, board_height) ||
-        !board_set_initial_layout(&board)) {
+        !board_set_chess960_layout(&board,
+                                   (chess960_index >= 0)
+                                     ? chess960_index
+                                     : BOARD_CHESS960_STANDARD) ||
+        !move_cache_init(&move_cache, &board)) {
         fprintf(stderr,
                 "Failed to initialize %zux%zu board.\n",
                 board_width,
                 board_height);
         return 1;
     }
+    board.variant = variant;
 
-    if (!render_startup()) {
+    Replay replay;
+    if (replay_path != NULL && !replay_load(&replay, &board, replay_path)) {
+        fprintf(stderr, "Failed to load replay '%s'.\n", replay_path);
+        move_cache_destroy(&move_cache);
+        board_destroy(&board);
+        if (index_path != NULL)
+            index_close(&index);
+        return 1;
+    }
+
+    profile_startup();
+
+    if (!render_startup(use_clock || analysis_lines > 0)) {
         fprintf(stderr, "Failed to start rendering.\n");
         goto cleanup;
     }
 
+    if (use_clock)
+        clock_start(&clock, board.turn);
+
+    /* Statistics of the current position, only updated when it changes */
+    IndexEntry position_stats = { 0 };
+    uint64_t stats_hash       = ~board.hash;
+
+    /*
+     * Background analysis of the current position, which is restarted when
+     * the position changes.
+     */
+    Analysis analysis;
+    bool is_analyzing = false;
+    SearchResult analysis_result;
+    unsigned analysis_generation = 0;
+
+    /*
+     * Ply typed by the user while reviewing a game, which is jumped to with
+     * the 'INPUT_KEY_GOTO' key.
+     */
+    size_t typed_ply   = 0;
+    bool is_typing_ply = false;
+
     bool should_quit = false;
     while (!should_quit) {
         /*
@@ -49,8 +246,66 @@ int main(void) {
          */
         board_assert_integrity(&board);
 
+        if (index_path != NULL && stats_hash != board.hash) {
+            const IndexEntry* entry = index_probe(&index, board.hash);
+            if (entry != NULL) {
+                position_stats = *entry;
+            } else {
+                memset(&position_stats, 0, sizeof(position_stats));
+                position_stats.hash = board.hash;
+            }
+            stats_hash = board.hash;
+        }
+
+        if (analysis_lines > 0 &&
+            (!is_analyzing || analysis.hash != board.hash)) {
+            if (is_analyzing)
+                analysis_stop(&analysis);
+
+            is_analyzing = analysis_start(&analysis,
+                                          &board,
+                                          analysis_lines,
+                                          use_clock ? &clock : NULL);
+            analysis_result.depth     = 0;
+            analysis_result.num_lines = 0;
+            analysis_generation       = 0;
+        }
+
+        if (is_analyzing)
+            analysis_poll(&analysis, &analysis_result, &analysis_generation);
+
+        /* Show the progress of the replay, and the last move */
+        char replay_status[64];
+        if (replay_path != NULL) {
+            char last_move[MOVE_STR_MAX] = "-";
+            if (replay.ply > 0)
+                move_to_str(&replay.moves[replay.ply - 1], last_move);
+            const int written = snprintf(replay_status,
+                                         sizeof(replay_status),
+                                         "Ply %zu/%zu, last move: %s",
+                                         replay.ply,
+                                         replay.num_plies,
+                                         last_move);
+            if (is_typing_ply && written > 0 &&
+                (size_t)written < sizeof(replay_status))
+                snprintf(replay_status + written,
+                         sizeof(replay_status) - written,
+                         ", go to ply: %zu",
+                         typed_ply);
+        }
+
         /* Render the board to the default backend */
-        if (!render_board(&board)) {
+        const RenderInfo render_info = {
+            .clock      = use_clock ? &clock : NULL,
+            .stats      = (index_path != NULL) ? &position_stats : NULL,
+            .status     = (replay_path != NULL) ? replay_status : NULL,
+            .analysis   = is_analyzing ? &analysis_result : NULL,
+            .move_cache = &move_cache,
+        };
+        PROFILE_BEGIN(PROFILE_SPAN_RENDER);
+        const bool rendered = render_board(&board, &render_info);
+        PROFILE_END(PROFILE_SPAN_RENDER);
+        if (!rendered) {
             fprintf(stderr, "Failed to render board. Aborting...\n");
             break;
         }
@@ -64,12 +319,90 @@ int main(void) {
             continue;
         }
 
+        /*
+         * When reviewing a game, the replay keys change the position, and
+         * moves can't be made.
+         */
+        if (replay_path != NULL) {
+            /* Digits are accumulated, limited to the last ply of the game */
+            if (input_key >= INPUT_KEY_DIGIT_0 &&
+                input_key <= INPUT_KEY_DIGIT_9) {
+                typed_ply = typed_ply * 10 + (input_key - INPUT_KEY_DIGIT_0);
+                if (typed_ply > replay.num_plies)
+                    typed_ply = replay.num_plies;
+                is_typing_ply = true;
+                continue;
+            }
+
+            size_t target_ply = replay.ply;
+            switch (input_key) {
+                case INPUT_KEY_NEXT:
+                    target_ply++;
+                    break;
+                case INPUT_KEY_PREV:
+                    if (target_ply > 0)
+                        target_ply--;
+                    break;
+                case INPUT_KEY_FIRST:
+                    target_ply = 0;
+                    break;
+                case INPUT_KEY_LAST:
+                    target_ply = replay.num_plies;
+                    break;
+                case INPUT_KEY_GOTO:
+                    if (is_typing_ply)
+                        target_ply = typed_ply;
+                    break;
+                case INPUT_KEY_SELECT:
+                    continue;
+                default:
+                    break;
+            }
+
+            /* Any other key clears the typed ply */
+            typed_ply     = 0;
+            is_typing_ply = false;
+
+            if (target_ply != replay.ply) {
+                replay_seek(&replay, &board, target_ply);
+                move_cache_invalidate(&move_cache);
+                board.selection.x = BOARD_COL_NONE;
+                board.selection.y = BOARD_ROW_NONE;
+            }
+        }
+
+        /* Once a player runs out of time, the game is over */
+        if (use_clock && clock_is_flagged(&clock, board.turn) &&
+            input_key == INPUT_KEY_SELECT)
+            continue;
+
         /* Process game-level user input */
-        input_process_game_key(&board, input_key);
+        const enum EPieceColor old_turn = board.turn;
+        PROFILE_BEGIN(PROFILE_SPAN_INPUT);
+        input_process_game_key(&board, &move_cache, input_key);
+        PROFILE_END(PROFILE_SPAN_INPUT);
+
+        /* If the player moved, switch the clocks */
+        if (use_clock && board.turn != old_turn)
+            clock_press(&clock);
     }
 
+    if (is_analyzing)
+        analysis_stop(&analysis);
+
 cleanup:
     render_cleanup();
+    if (replay_path != NULL)
+        replay_destroy(&replay);
+    move_cache_destroy(&move_cache);
     board_destroy(&board);
+    if (index_path != NULL)
+        index_close(&index);
+
+    if (show_stats) {
+        profile_merge_thread();
+        profile_print_report(stdout);
+    }
+
     return 0;
 }
@@ -0,0 +1,973 @@
+/*
+ * Copyright 2025 8dcc
+ *
+ * This file is part of 8dcc's Chess.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "include/move.h"
+#include "include/board.h"
+#include "include/eval.h"
+#include "include/hash.h"
+#include "include/piece.h"
+#include "include/profile.h"
+#include "include/rules.h"
+#include "include/util.h"
+
+/*
+ * Offsets for the movement of each type of piece, as X and Y deltas.
+ */
+static const int g_knight_offsets[][2] = {
+    { 1, 2 }, { 2, 1 }, { 2, -1 }, { 1, -2 },
+    { -1, -2 }, { -2, -1 }, { -2, 1 }, { -1, 2 },
+};
+static const int g_king_offsets[][2] = {
+    { 0, -1 }, { 1, -1 }, { 1, 0 }, { 1, 1 },
+    { 0, 1 }, { -1, 1 }, { -1, 0 }, { -1, -1 },
+};
+static const int g_rook_offsets[][2] = {
+    { 0, -1 }, { 1, 0 }, { 0, 1 }, { -1, 0 },
+};
+static const int g_bishop_offsets[][2] = {
+    { 1, -1 }, { 1, 1 }, { -1, 1 }, { -1, -1 },
+};
+
+/*
+ * Pieces that a pawn can be promoted to, in the order they are generated.
+ */
+static const enum EPieceType g_promotion_types[] = {
+    PIECE_TYPE_QUEEN,
+    PIECE_TYPE_ROOK,
+    PIECE_TYPE_BISHOP,
+    PIECE_TYPE_KNIGHT,
+};
+
+/*----------------------------------------------------------------------------*/
+
+/*
+ * Return the opposite of the specified color.
+ */
+static inline enum EPieceColor opposite_color(enum EPieceColor color) {
+    return (color == PIECE_COL_WHITE) ? PIECE_COL_BLACK : PIECE_COL_WHITE;
+}
+
+/*
+ * Return the Y delta for the pawns of the specified color. White pawns move
+ * towards the top of the board, which is stored first.
+ */
+static inline int pawn_direction(enum EPieceColor color) {
+    return (color == PIECE_COL_WHITE) ? -1 : 1;
+}
+
+/*
+ * Check if the specified coordinates are inside the board.
+ */
+static inline bool is_inside(const Board* board, int x, int y) {
+    return x >= 0 && x < board->width && y >= 0 && y < board->height;
+}
+
+/*
+ * Return the cell at the specified coordinates, which must be inside the board.
+ */
+static inline BoardCell* cell_at(const Board* board, int x, int y) {
+    return board_cell_at(board, (BoardCoordinate){ x, y });
+}
+
+/*
+ * Check if the cell at the specified coordinates has a piece with the specified
+ * type and color.
+ */
+static inline bool has_piece(const Board* board, int x, int y,
+                             enum EPieceType type, enum EPieceColor color) {
+    const BoardCell* cell = cell_at(board, x, y);
+    return cell->has_piece && cell->piece.type == type &&
+           cell->piece.color == color;
+}
+
+/*
+ * Append a move to the specified list.
+ */
+static inline void push_move(MoveList* list, int from_x, int from_y, int to_x,
+                             int to_y, enum EPieceType promotion, int flags) {
+    assert(list->count < MOVELIST_MAX);
+
+    Move* move      = &list->moves[list->count++];
+    move->from.x    = from_x;
+    move->from.y    = from_y;
+    move->to.x      = to_x;
+    move->to.y      = to_y;
+    move->promotion = promotion;
+    move->flags     = flags;
+}
+
+/*
+ * Update the incremental hash and evaluation of the board after placing the
+ * piece of the specified cell there.
+ */
+static inline void add_piece_state(Board* board, const BoardCell* cell, int x,
+                                   int y) {
+    board->hash ^= hash_piece(&cell->piece, board->width * y + x);
+    board->eval += eval_piece(board, &cell->piece, x, y);
+}
+
+/*
+ * Update the incremental hash and evaluation of the board before removing the
+ * piece of the specified cell.
+ */
+static inline void remove_piece_state(Board* board, const BoardCell* cell,
+                                      int x, int y) {
+    board->hash ^= hash_piece(&cell->piece, board->width * y + x);
+    board->eval -= eval_piece(board, &cell->piece, x, y);
+}
+
+/*
+ * Return both castling rights of the specified color, which are lost when its
+ * king moves.
+ */
+static inline int king_castling_rights(enum EPieceColor color) {
+    return board_castling_right(color, true) |
+           board_castling_right(color, false);
+}
+
+/*
+ * Return the castling rights that are lost when a piece moves from or to the
+ * specified cell, because it's the initial cell of a castling rook.
+ */
+static int castling_rights_of_cell(const Board* board, int x, int y) {
+    int result = BOARD_CASTLE_NONE;
+
+    if (y == board->height - 1) {
+        if (x == board->castling_rook_x[0])
+            result |= BOARD_CASTLE_WHITE_KING;
+        if (x == board->castling_rook_x[1])
+            result |= BOARD_CASTLE_WHITE_QUEEN;
+    } else if (y == 0) {
+        if (x == board->castling_rook_x[2])
+            result |= BOARD_CASTLE_BLACK_KING;
+        if (x == board->castling_rook_x[3])
+            result |= BOARD_CASTLE_BLACK_QUEEN;
+    }
+
+    return result;
+}
+
+/*----------------------------------------------------------------------------*/
+
+/*
+ * Generate the moves of the pawn at the specified position.
+ */
+static void generate_pawn_moves(const Board* board, MoveList* list, int x,
+                                int y) {
+    const enum EPieceColor color = board->turn;
+    const int dir                = pawn_direction(color);
+    const int start_y = (color == PIECE_COL_WHITE) ? board->height - 2 : 1;
+    const int last_y  = (color == PIECE_COL_WHITE) ? 0 : board->height - 1;
+
+    const int to_y = y + dir;
+    if (!is_inside(board, x, to_y))
+        return;
+
+    /* Pushes */
+    if (!cell_at(board, x, to_y)->has_piece) {
+        if (to_y == last_y) {
+            for (size_t i = 0; i < ARRLEN(g_promotion_types); i++)
+                push_move(list,
+                          x,
+                          y,
+                          x,
+                          to_y,
+                          g_promotion_types[i],
+                          MOVE_FLAG_PROMOTION);
+        } else {
+            push_move(list, x, y, x, to_y, PIECE_TYPE_UNKNOWN, MOVE_FLAG_NONE);
+
+            if (y == start_y && !cell_at(board, x, to_y + dir)->has_piece)
+                push_move(list,
+                          x,
+                          y,
+                          x,
+                          to_y + dir,
+                          PIECE_TYPE_UNKNOWN,
+                          MOVE_FLAG_DOUBLE_PUSH);
+        }
+    }
+
+    /* Captures */
+    for (int dx = -1; dx <= 1; dx += 2) {
+        const int to_x = x + dx;
+        if (!is_inside(board, to_x, to_y))
+            continue;
+
+        if (board->en_passant.x == to_x && board->en_passant.y == to_y) {
+            push_move(list,
+                      x,
+                      y,
+                      to_x,
+                      to_y,
+                      PIECE_TYPE_UNKNOWN,
+                      MOVE_FLAG_CAPTURE | MOVE_FLAG_EN_PASSANT);
+            continue;
+        }
+
+        const BoardCell* target = cell_at(board, to_x, to_y);
+        if (!target->has_piece || target->piece.color == color)
+            continue;
+
+        if (to_y == last_y) {
+            for (size_t i = 0; i < ARRLEN(g_promotion_types); i++)
+                push_move(list,
+                          x,
+                          y,
+                          to_x,
+                          to_y,
+                          g_promotion_types[i],
+                          MOVE_FLAG_CAPTURE | MOVE_FLAG_PROMOTION);
+        } else {
+            push_move(list,
+                      x,
+                      y,
+                      to_x,
+                      to_y,
+                      PIECE_TYPE_UNKNOWN,
+                      MOVE_FLAG_CAPTURE);
+        }
+    }
+}
+
+/*
+ * Generate the moves of a piece that jumps to fixed offsets (i.e. knights and
+ * kings), at the specified position.
+ */
+static void generate_step_moves(const Board* board, MoveList* list, int x,
+                                int y, const int (*offsets)[2],
+                                size_t num_offsets) {
+    for (size_t i = 0; i < num_offsets; i++) {
+        const int to_x = x + offsets[i][0];
+        const int to_y = y + offsets[i][1];
+        if (!is_inside(board, to_x, to_y))
+            continue;
+
+        const BoardCell* target = cell_at(board, to_x, to_y);
+        if (target->has_piece && target->piece.color == board->turn)
+            continue;
+
+        const int flags =
+          target->has_piece ? MOVE_FLAG_CAPTURE : MOVE_FLAG_NONE;
+        push_move(list, x, y, to_x, to_y, PIECE_TYPE_UNKNOWN, flags);
+    }
+}
+
+/*
+ * Generate the moves of a piece that slides in the specified directions (i.e.
+ * rooks, bishops and queens), at the specified position.
+ */
+static void generate_slide_moves(const Board* board, MoveList* list, int x,
+                                 int y, const int (*offsets)[2],
+                                 size_t num_offsets) {
+    for (size_t i = 0; i < num_offsets; i++) {
+        int to_x = x + offsets[i][0];
+        int to_y = y + offsets[i][1];
+
+        for (; is_inside(board, to_x, to_y);
+             to_x += offsets[i][0], to_y += offsets[i][1]) {
+            const BoardCell* target = cell_at(board, to_x, to_y);
+            if (target->has_piece && target->piece.color == board->turn)
+                break;
+
+            const int flags =
+              target->has_piece ? MOVE_FLAG_CAPTURE : MOVE_FLAG_NONE;
+            push_move(list, x, y, to_x, to_y, PIECE_TYPE_UNKNOWN, flags);
+
+            if (target->has_piece)
+                break;
+        }
+    }
+}
+
+/*
+ * Check if all cells between 'x0' and 'x1' (inclusive) in the specified row are
+ * empty, except the cells of the castling king and rook.
+ */
+static bool is_castling_path_empty(const Board* board, int y, int x0, int x1,
+                                   int king_x, int rook_x) {
+    for (int x = x0; x <= x1; x++)
+        if (x != king_x && x != rook_x && cell_at(board, x, y)->has_piece)
+            return false;
+
+    return true;
+}
+
+/*
+ * Check if any cell between 'x0' and 'x1' (inclusive) in the specified row is
+ * attacked by the specified color.
+ */
+static bool is_row_attacked(const Board* board, int y, int x0, int x1,
+                            enum EPieceColor attacker) {
+    for (int x = x0; x <= x1; x++)
+        if (move_is_attacked(board, (BoardCoordinate){ x, y }, attacker))
+            return true;
+
+    return false;
+}
+
+/*
+ * Generate the castling moves of the king at the specified position, if the
+ * king and the rook have a free path, and if the king doesn't pass through
+ * attacked cells. The rook can be in any column, for supporting Chess960.
+ */
+static void generate_castling_moves(const Board* board, MoveList* list, int x,
+                                    int y) {
+    const enum EPieceColor color    = board->turn;
+    const enum EPieceColor opponent = opposite_color(color);
+    const int first_y = (color == PIECE_COL_WHITE) ? board->height - 1 : 0;
+
+    if (y != first_y)
+        return;
+
+    for (int i = 0; i < 2; i++) {
+        const bool king_side            = (i == 0);
+        const enum EBoardCastling right = board_castling_right(color,
+                                                               king_side);
+        if ((board->castling & right) == 0)
+            continue;
+
+        const int rook_x = board->castling_rook_x[board_castling_index(right)];
+        if ((rook_x > x) != king_side ||
+            !has_piece(board, rook_x, y, PIECE_TYPE_ROOK, color))
+            continue;
+
+        const Move move = {
+            .from = { x, y },
+            .to   = { rook_x, y },
+        };
+        const int king_dst_x = move_castling_king_x(&move);
+        const int rook_dst_x = move_castling_rook_x(&move);
+
+        const int min_x = MIN(MIN(x, rook_x), MIN(king_dst_x, rook_dst_x));
+        const int max_x = MAX(MAX(x, rook_x), MAX(king_dst_x, rook_dst_x));
+        if (!is_castling_path_empty(board, y, min_x, max_x, x, rook_x) ||
+            is_row_attacked(board,
+                            y,
+                            MIN(x, king_dst_x),
+                            MAX(x, king_dst_x),
+                            opponent))
+            continue;
+
+        push_move(list, x, y, rook_x, y, PIECE_TYPE_UNKNOWN, MOVE_FLAG_CASTLE);
+    }
+}
+
+/*
+ * Move the king and the rook of the specified castling move. Both pieces are
+ * removed before placing them, since their cells might overlap in Chess960.
+ */
+static void make_castling(Board* board, const Move* move) {
+    const int y          = move->from.y;
+    const int king_dst_x = move_castling_king_x(move);
+    const int rook_dst_x = move_castling_rook_x(move);
+
+    BoardCell* king_src  = cell_at(board, move->from.x, y);
+    BoardCell* rook_src  = cell_at(board, move->to.x, y);
+    const BoardCell king = *king_src;
+    const BoardCell rook = *rook_src;
+    BoardCell* king_dst  = cell_at(board, king_dst_x, y);
+    BoardCell* rook_dst  = cell_at(board, rook_dst_x, y);
+
+    remove_piece_state(board, king_src, move->from.x, y);
+    remove_piece_state(board, rook_src, move->to.x, y);
+    king_src->has_piece = false;
+    rook_src->has_piece = false;
+
+    *king_dst = king;
+    *rook_dst = rook;
+    add_piece_state(board, king_dst, king_dst_x, y);
+    add_piece_state(board, rook_dst, rook_dst_x, y);
+}
+
+/*
+ * Undo a castling move made with 'make_castling'. The hash and evaluation are
+ * not updated, since they are restored by the caller.
+ */
+static void unmake_castling(Board* board, const Move* move) {
+    const int y          = move->from.y;
+    BoardCell* king_dst  = cell_at(board, move_castling_king_x(move), y);
+    BoardCell* rook_dst  = cell_at(board, move_castling_rook_x(move), y);
+    const BoardCell king = *king_dst;
+    const BoardCell rook = *rook_dst;
+
+    king_dst->has_piece = false;
+    rook_dst->has_piece = false;
+    *cell_at(board, move->from.x, y) = king;
+    *cell_at(board, move->to.x, y)   = rook;
+}
+
+/*
+ * Generate the legal moves of the player in turn, by removing the pseudo-legal
+ * moves that leave the king in check, keeping the order. The rules of the
+ * variant are not checked.
+ */
+static void generate_legal_moves(Board* board, MoveList* list) {
+    PROFILE_BEGIN(PROFILE_SPAN_MOVEGEN);
+
+    move_generate_pseudo_legal(board, list);
+
+    const enum EPieceColor color = board->turn;
+    size_t num_legal             = 0;
+    for (size_t i = 0; i < list->count; i++) {
+        MoveUndo undo;
+        move_make(board, &list->moves[i], &undo);
+        const bool is_legal = !move_in_check(board, color);
+        move_unmake(board, &list->moves[i], &undo);
+
+        if (is_legal)
+            list->moves[num_legal++] = list->moves[i];
+    }
+    list->count = num_legal;
+
+    PROFILE_END(PROFILE_SPAN_MOVEGEN);
+}
+
+/*
+ * Define the functions that depend on the rules of a variant, with the name of
+ * the variant as suffix. See "rules.h".
+ */
+#define DEFINE_VARIANT_FUNCTIONS(NAME, VARIANT)                                \
+    static void generate_legal_##NAME(Board* board, MoveList* list) {          \
+        if (rules_is_lost_##NAME(board)) {                                     \
+            list->count = 0;                                                   \
+            return;                                                            \
+        }                                                                      \
+                                                                               \
+        generate_legal_moves(board, list);                                     \
+    }                                                                          \
+                                                                               \
+    static uint64_t perft_##NAME(Board* board, int depth) {                    \
+        if (depth <= 0)                                                        \
+            return 1;                                                          \
+                                                                               \
+        MoveList list;                                                         \
+        generate_legal_##NAME(board, &list);                                   \
+                                                                               \
+        /* The leaf nodes don't need to be made */                             \
+        if (depth == 1)                                                        \
+            return list.count;                                                 \
+                                                                               \
+        uint64_t result = 0;                                                   \
+        for (size_t i = 0; i < list.count; i++) {                              \
+            MoveUndo undo;                                                     \
+            move_make(board, &list.moves[i], &undo);                           \
+            result += perft_##NAME(board, depth - 1);                          \
+            move_unmake(board, &list.moves[i], &undo);                         \
+        }                                                                      \
+                                                                               \
+        return result;                                                         \
+    }
+
+VARIANT_LIST(DEFINE_VARIANT_FUNCTIONS)
+
+#define DISPATCH_GENERATE_LEGAL(NAME, VARIANT)                                 \
+    case VARIANT:                                                              \
+        generate_legal_##NAME(board, list);                                    \
+        break;
+
+#define DISPATCH_PERFT(NAME, VARIANT)                                          \
+    case VARIANT:                                                              \
+        return perft_##NAME(board, depth);
+
+/*----------------------------------------------------------------------------*/
+
+bool move_is_attacked(const Board* board, BoardCoordinate coord,
+                      enum EPieceColor attacker) {
+    const int x = coord.x;
+    const int y = coord.y;
+
+    /* Pawns attack from the opposite direction of their movement */
+    const int pawn_y = y - pawn_direction(attacker);
+    for (int dx = -1; dx <= 1; dx += 2)
+        if (is_inside(board, x + dx, pawn_y) &&
+            has_piece(board, x + dx, pawn_y, PIECE_TYPE_PAWN, attacker))
+            return true;
+
+    for (size_t i = 0; i < ARRLEN(g_knight_offsets); i++) {
+        const int from_x = x + g_knight_offsets[i][0];
+        const int from_y = y + g_knight_offsets[i][1];
+        if (is_inside(board, from_x, from_y) &&
+            has_piece(board, from_x, from_y, PIECE_TYPE_KNIGHT, attacker))
+            return true;
+    }
+
+    for (size_t i = 0; i < ARRLEN(g_king_offsets); i++) {
+        const int from_x = x + g_king_offsets[i][0];
+        const int from_y = y + g_king_offsets[i][1];
+        if (is_inside(board, from_x, from_y) &&
+            has_piece(board, from_x, from_y, PIECE_TYPE_KING, attacker))
+            return true;
+    }
+
+    /*
+     * Slide from the target cell in each direction, until a piece is found,
+     * and check if it can slide back in that direction.
+     */
+    for (size_t i = 0; i < ARRLEN(g_king_offsets); i++) {
+        const int dx = g_king_offsets[i][0];
+        const int dy = g_king_offsets[i][1];
+
+        const bool is_diagonal = (dx != 0 && dy != 0);
+
+        for (int from_x = x + dx, from_y = y + dy;
+             is_inside(board, from_x, from_y);
+             from_x += dx, from_y += dy) {
+            const BoardCell* cell = cell_at(board, from_x, from_y);
+            if (!cell->has_piece)
+                continue;
+
+            if (cell->piece.color == attacker &&
+                (cell->piece.type == PIECE_TYPE_QUEEN ||
+                 cell->piece.type ==
+                   (is_diagonal ? PIECE_TYPE_BISHOP : PIECE_TYPE_ROOK)))
+                return true;
+            break;
+        }
+    }
+
+    return false;
+}
+
+bool move_in_check(const Board* board, enum EPieceColor color) {
+    for (int y = 0; y < board->height; y++)
+        for (int x = 0; x < board->width; x++)
+            if (has_piece(board, x, y, PIECE_TYPE_KING, color))
+                return move_is_attacked(board,
+                                        (BoardCoordinate){ x, y },
+                                        opposite_color(color));
+
+    return false;
+}
+
+bool move_can_capture_en_passant(const Board* board) {
+    if (board->en_passant.x == BOARD_COL_NONE)
+        return false;
+
+    const enum EPieceColor color = board->turn;
+    const int ep_x               = board->en_passant.x;
+    const int ep_y               = board->en_passant.y;
+
+    /* The captured pawn is in the same row as the pawns that can capture it */
+    const int pawn_y = (color == PIECE_COL_WHITE) ? ep_y + 1 : ep_y - 1;
+    if (!is_inside(board, ep_x, pawn_y))
+        return false;
+
+    for (int dx = -1; dx <= 1; dx += 2) {
+        const int x = ep_x + dx;
+        if (!is_inside(board, x, pawn_y) ||
+            !has_piece(board, x, pawn_y, PIECE_TYPE_PAWN, color))
+            continue;
+
+        /* Make the capture in a copy of the cells, and check the king */
+        BoardCell cells[HASH_MAX_CELLS];
+        assert(board->width * board->height <= HASH_MAX_CELLS);
+        memcpy(cells,
+               board->cells,
+               board->width * board->height * sizeof(BoardCell));
+
+        Board copy = *board;
+        copy.cells = cells;
+        *cell_at(&copy, ep_x, ep_y)             = *cell_at(&copy, x, pawn_y);
+        cell_at(&copy, x, pawn_y)->has_piece    = false;
+        cell_at(&copy, ep_x, pawn_y)->has_piece = false;
+
+        if (!move_in_check(&copy, color))
+            return true;
+    }
+
+    return false;
+}
+
+void move_generate_pseudo_legal(const Board* board, MoveList* list) {
+    list->count = 0;
+
+    for (int y = 0; y < board->height; y++) {
+        for (int x = 0; x < board->width; x++) {
+            const BoardCell* cell = cell_at(board, x, y);
+            if (!cell->has_piece || cell->piece.color != board->turn)
+                continue;
+
+            switch (cell->piece.type) {
+                case PIECE_TYPE_PAWN:
+                    generate_pawn_moves(board, list, x, y);
+                    break;
+
+                case PIECE_TYPE_KNIGHT:
+                    generate_step_moves(board,
+                                        list,
+                                        x,
+                                        y,
+                                        g_knight_offsets,
+                                        ARRLEN(g_knight_offsets));
+                    break;
+
+                case PIECE_TYPE_BISHOP:
+                    generate_slide_moves(board,
+                                         list,
+                                         x,
+                                         y,
+                                         g_bishop_offsets,
+                                         ARRLEN(g_bishop_offsets));
+                    break;
+
+                case PIECE_TYPE_ROOK:
+                    generate_slide_moves(board,
+                                         list,
+                                         x,
+                                         y,
+                                         g_rook_offsets,
+                                         ARRLEN(g_rook_offsets));
+                    break;
+
+                case PIECE_TYPE_QUEEN:
+                    generate_slide_moves(board,
+                                         list,
+                                         x,
+                                         y,
+                                         g_king_offsets,
+                                         ARRLEN(g_king_offsets));
+                    break;
+
+                case PIECE_TYPE_KING:
+                    generate_step_moves(board,
+                                        list,
+                                        x,
+                                        y,
+                                        g_king_offsets,
+                                        ARRLEN(g_king_offsets));
+                    generate_castling_moves(board, list, x, y);
+                    break;
+
+                case PIECE_TYPE_UNKNOWN:
+                    break;
+            }
+        }
+    }
+}
+
+void move_generate_legal(Board* board, MoveList* list) {
+    switch (board->variant) {
+        VARIANT_LIST(DISPATCH_GENERATE_LEGAL)
+    }
+}
+
+void move_make(Board* board, const Move* move, MoveUndo* undo) {
+    BoardCell* src = board_cell_at(board, move->from);
+    BoardCell* dst = board_cell_at(board, move->to);
+
+    undo->castling       = board->castling;
+    undo->en_passant     = board->en_passant;
+    undo->halfmove_clock = board->halfmove_clock;
+    undo->hash           = board->hash;
+    undo->en_passant_key = board->en_passant_key;
+    undo->eval           = board->eval;
+
+    /* Remove the old state from the hash, it will be added back at the end */
+    board->hash ^= hash_castling(board->castling);
+    board->hash ^= board->en_passant_key;
+
+    const bool is_pawn           = (src->piece.type == PIECE_TYPE_PAWN);
+    const bool is_king           = (src->piece.type == PIECE_TYPE_KING);
+    const enum EPieceColor color = src->piece.color;
+
+    if (move->flags & MOVE_FLAG_CASTLE) {
+        undo->captured.has_piece = false;
+        make_castling(board, move);
+    } else {
+        /* The captured pawn of an en passant is not in the destination cell */
+        const int captured_y =
+          (move->flags & MOVE_FLAG_EN_PASSANT) ? move->from.y : move->to.y;
+        BoardCell* captured = cell_at(board, move->to.x, captured_y);
+        undo->captured      = *captured;
+        if (captured->has_piece)
+            remove_piece_state(board, captured, move->to.x, captured_y);
+        captured->has_piece = false;
+
+        remove_piece_state(board, src, move->from.x, move->from.y);
+        *dst           = *src;
+        src->has_piece = false;
+        if (move->flags & MOVE_FLAG_PROMOTION)
+            dst->piece.type = move->promotion;
+        add_piece_state(board, dst, move->to.x, move->to.y);
+    }
+
+    /*
+     * Moving or capturing a king loses both castling rights of its color, and
+     * moving or capturing a castling rook loses its right.
+     */
+    if (is_king)
+        board->castling &= ~king_castling_rights(color);
+    if (undo->captured.has_piece &&
+        undo->captured.piece.type == PIECE_TYPE_KING)
+        board->castling &= ~king_castling_rights(undo->captured.piece.color);
+    board->castling &=
+      ~(castling_rights_of_cell(board, move->from.x, move->from.y) |
+        castling_rights_of_cell(board, move->to.x, move->to.y));
+    board->hash ^= hash_castling(board->castling);
+
+    if (move->flags & MOVE_FLAG_DOUBLE_PUSH) {
+        board->en_passant.x = move->from.x;
+        board->en_passant.y = (move->from.y + move->to.y) / 2;
+    } else {
+        board->en_passant.x = BOARD_COL_NONE;
+        board->en_passant.y = BOARD_ROW_NONE;
+    }
+
+    if (is_pawn || (move->flags & MOVE_FLAG_CAPTURE))
+        board->halfmove_clock = 0;
+    else
+        board->halfmove_clock++;
+
+    if (board->turn == PIECE_COL_BLACK)
+        board->fullmove_number++;
+
+    board->turn = opposite_color(board->turn);
+    board->hash ^= hash_black_turn();
+
+    /*
+     * The en passant cell depends on the turn, so it's hashed at the end. Only
+     * double pushes can leave an en passant cell.
+     */
+    board->en_passant_key = (move->flags & MOVE_FLAG_DOUBLE_PUSH)
+                              ? board_en_passant_key(board)
+                              : 0;
+    board->hash ^= board->en_passant_key;
+}
+
+void move_unmake(Board* board, const Move* move, const MoveUndo* undo) {
+    BoardCell* src = board_cell_at(board, move->from);
+    BoardCell* dst = board_cell_at(board, move->to);
+
+    board->turn = opposite_color(board->turn);
+    if (board->turn == PIECE_COL_BLACK)
+        board->fullmove_number--;
+
+    board->castling       = undo->castling;
+    board->en_passant     = undo->en_passant;
+    board->halfmove_clock = undo->halfmove_clock;
+    board->hash           = undo->hash;
+    board->en_passant_key = undo->en_passant_key;
+    board->eval           = undo->eval;
+
+    if (move->flags & MOVE_FLAG_CASTLE) {
+        unmake_castling(board, move);
+        return;
+    }
+
+    *src = *dst;
+    if (move->flags & MOVE_FLAG_PROMOTION)
+        src->piece.type = PIECE_TYPE_PAWN;
+
+    if (move->flags & MOVE_FLAG_EN_PASSANT) {
+        dst->has_piece = false;
+        *cell_at(board, move->to.x, move->from.y) = undo->captured;
+    } else {
+        *dst = undo->captured;
+    }
+}
+
+uint64_t move_perft(Board* board, int depth) {
+    switch (board->variant) {
+        VARIANT_LIST(DISPATCH_PERFT)
+    }
+
+    return 0;
+}
+
+bool move_from_str(Board* board, const char* str, Move* dst) {
+    MoveList list;
+    move_generate_pseudo_legal(board, &list);
+
+    /* Only the legality of the matching move needs to be checked */
+    for (size_t i = 0; i < list.count; i++) {
+        char move_str[MOVE_STR_MAX];
+        move_to_str(&list.moves[i], move_str);
+        if (strcmp(move_str, str) != 0)
+            continue;
+
+        const enum EPieceColor color = board->turn;
+
+        MoveUndo undo;
+        move_make(board, &list.moves[i], &undo);
+        const bool is_legal = !move_in_check(board, color);
+        move_unmake(board, &list.moves[i], &undo);
+
+        if (!is_legal)
+            return false;
+
+        *dst = list.moves[i];
+        return true;
+    }
+
+    return false;
+}
+
+bool move_make_legal(Board* board, MoveCache* cache, BoardCoordinate from,
+                     BoardCoordinate to) {
+    PROFILE_BEGIN(PROFILE_SPAN_MAKE_MOVE);
+
+    MoveList local_list;
+    const MoveList* list;
+    if (cache != NULL) {
+        list = move_cache_get_legal(cache, board);
+    } else {
+        move_generate_legal(board, &local_list);
+        list = &local_list;
+    }
+
+    /* Promotions to queens are generated first, so they are found first */
+    const Move* found = NULL;
+    for (size_t i = 0; i < list->count; i++) {
+        const Move* move = &list->moves[i];
+        if (move->from.x == from.x && move->from.y == from.y &&
+            move->to.x == to.x && move->to.y == to.y) {
+            found = move;
+            break;
+        }
+    }
+
+    /*
+     * Castling moves can also be selected with the destination of the king,
+     * unless it's also the destination of a normal king move.
+     */
+    for (size_t i = 0; found == NULL && i < list->count; i++) {
+        const Move* move = &list->moves[i];
+        if ((move->flags & MOVE_FLAG_CASTLE) && move->from.x == from.x &&
+            move->from.y == from.y && move_castling_king_x(move) == to.x &&
+            move->to.y == to.y)
+            found = move;
+    }
+
+    if (found != NULL) {
+        MoveUndo undo;
+        const Move move = *found;
+        move_make(board, &move, &undo);
+        if (cache != NULL)
+            move_cache_invalidate(cache);
+    }
+
+    PROFILE_END(PROFILE_SPAN_MAKE_MOVE);
+    return found != NULL;
+}
+
+bool move_cache_init(MoveCache* cache, const Board* board) {
+    cache->highlights = calloc(board->width * board->height, 1);
+    if (cache->highlights == NULL)
+        return false;
+
+    move_cache_invalidate(cache);
+    return true;
+}
+
+void move_cache_destroy(MoveCache* cache) {
+    free(cache->highlights);
+    cache->highlights = NULL;
+}
+
+void move_cache_invalidate(MoveCache* cache) {
+    cache->is_valid    = false;
+    cache->selection.x = BOARD_COL_NONE;
+    cache->selection.y = BOARD_ROW_NONE;
+}
+
+const MoveList* move_cache_get_legal(MoveCache* cache, Board* board) {
+    if (!cache->is_valid) {
+        move_generate_legal(board, &cache->legal);
+        cache->is_valid = true;
+    }
+
+    return &cache->legal;
+}
+
+/*
+ * Return the highlight of the destination of the specified legal move, which is
+ * made temporarily for checking if the moved piece would be attacked there.
+ */
+static enum EMoveHighlight get_move_highlight(Board* board, const Move* move) {
+    const bool is_capture = (move->flags & MOVE_FLAG_CAPTURE) != 0;
+
+    /* The king can't castle into an attacked cell, and the rook is defended */
+    if (!(move->flags & MOVE_FLAG_CASTLE)) {
+        MoveUndo undo;
+        move_make(board, move, &undo);
+        const bool is_attacked = move_is_attacked(board, move->to, board->turn);
+        move_unmake(board, move, &undo);
+
+        if (is_attacked)
+            return is_capture ? MOVE_HIGHLIGHT_ATTACKED_CAPTURE
+                              : MOVE_HIGHLIGHT_ATTACKED_TARGET;
+    }
+
+    return is_capture ? MOVE_HIGHLIGHT_CAPTURE : MOVE_HIGHLIGHT_TARGET;
+}
+
+void move_cache_update_selection(MoveCache* cache, Board* board) {
+    const size_t num_cells = board->width * board->height;
+    cache->selection       = board->selection;
+    memset(cache->highlights, MOVE_HIGHLIGHT_NONE, num_cells);
+
+    if (board->selection.x == BOARD_COL_NONE)
+        return;
+
+    const MoveList* list = move_cache_get_legal(cache, board);
+    for (size_t i = 0; i < list->count; i++) {
+        const Move* move = &list->moves[i];
+        if (move->from.x != board->selection.x ||
+            move->from.y != board->selection.y)
+            continue;
+
+        cache->highlights[board->width * move->to.y + move->to.x] =
+          get_move_highlight(board, move);
+
+        /* Castling moves also highlight the destination of the king */
+        if ((move->flags & MOVE_FLAG_CASTLE) &&
+            move_castling_king_x(move) != move->from.x)
+            cache->highlights[board->width * move->to.y +
+                              move_castling_king_x(move)] =
+              MOVE_HIGHLIGHT_TARGET;
+    }
+}
+
+void move_to_str(const Move* move, char* dst) {
+    /* TODO: Support boards with more than 9 rows */
+    dst[0] = 'a' + move->from.x;
+    dst[1] = '0' + (BOARD_ROW_1 + 1 - move->from.y);
+    dst[2] = 'a' + move->to.x;
+    dst[3] = '0' + (BOARD_ROW_1 + 1 - move->to.y);
+
+    /* Castling from the standard cells, see the comment in "move.h" */
+    if ((move->flags & MOVE_FLAG_CASTLE) && move->from.x == BOARD_COL_E &&
+        (move->to.x == BOARD_COL_A || move->to.x == BOARD_COL_H))
+        dst[2] = 'a' + move_castling_king_x(move);
+
+    if (move->flags & MOVE_FLAG_PROMOTION) {
+        const Piece piece = { move->promotion, PIECE_COL_BLACK };
+        dst[4]            = piece_get_fen_char(&piece);
+        dst[5]            = '\0';
+    } else {
+        dst[4] = '\0';
+    }
+}
@@ -0,0 +1,125 @@
+/*
+ * Copyright 2025 8dcc
+ *
+ * This file is part of 8dcc's Chess.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#define _POSIX_C_SOURCE 199309L /* clock_gettime */
+
+#include <stdint.h>
+#include <stdio.h>
+#include <time.h>
+
+#include "include/profile.h"
+#include "include/util.h"
+
+#ifdef CHESS_PROFILE
+
+/*
+ * Names of each profiling span, used in the report.
+ */
+static const char* g_span_names[] = {
+    [PROFILE_SPAN_RENDER]       = "render_board",
+    [PROFILE_SPAN_INPUT]        = "input",
+    [PROFILE_SPAN_MAKE_MOVE]    = "make_move",
+    [PROFILE_SPAN_MOVEGEN]      = "movegen",
+    [PROFILE_SPAN_EVAL]         = "eval",
+    [PROFILE_SPAN_INDEX_INSERT] = "index_insert",
+    [PROFILE_SPAN_INDEX_PROBE]  = "index_probe",
+    [PROFILE_SPAN_SEARCH]       = "search_iterate",
+};
+
+/*
+ * Counters of the current thread, and global counters that are updated from
+ * 'profile_merge_thread'.
+ */
+__thread ProfileCounters g_profile_thread_counters;
+static ProfileCounters g_profile_global_counters;
+
+/*
+ * Reference times stored in 'profile_startup', for calibrating the ticks.
+ */
+static uint64_t g_start_ticks;
+static uint64_t g_start_ns;
+
+/*----------------------------------------------------------------------------*/
+
+uint64_t profile_ticks_slow(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000 + ts.tv_nsec;
+}
+
+void profile_startup(void) {
+    g_start_ticks = profile_ticks();
+    g_start_ns    = profile_ticks_slow();
+}
+
+void profile_merge_thread(void) {
+    for (int i = 0; i < NUM_PROFILE_SPANS; i++) {
+        __atomic_fetch_add(&g_profile_global_counters.calls[i],
+                           g_profile_thread_counters.calls[i],
+                           __ATOMIC_RELAXED);
+        __atomic_fetch_add(&g_profile_global_counters.ticks[i],
+                           g_profile_thread_counters.ticks[i],
+                           __ATOMIC_RELAXED);
+        g_profile_thread_counters.calls[i] = 0;
+        g_profile_thread_counters.ticks[i] = 0;
+    }
+}
+
+void profile_print_report(FILE* fp) {
+    /* Number of nanoseconds per tick, measured since the startup */
+    const uint64_t elapsed_ticks = profile_ticks() - g_start_ticks;
+    const uint64_t elapsed_ns    = profile_ticks_slow() - g_start_ns;
+    const double ns_per_tick =
+      (elapsed_ticks == 0) ? 1.0 : (double)elapsed_ns / elapsed_ticks;
+
+    fprintf(fp,
+            "%-16s %12s %14s %12s %8s\n",
+            "SPAN",
+            "CALLS",
+            "TOTAL (ms)",
+            "AVG (ns)",
+            "TIME %");
+
+    for (size_t i = 0; i < ARRLEN(g_span_names); i++) {
+        const uint64_t calls  = g_profile_global_counters.calls[i];
+        const double total_ns =
+          g_profile_global_counters.ticks[i] * ns_per_tick;
+
+        fprintf(fp,
+                "%-16s %12llu %14.3f %12.1f %7.2f%%\n",
+                g_span_names[i],
+                (unsigned long long)calls,
+                total_ns / 1e6,
+                (calls == 0) ? 0.0 : total_ns / calls,
+                (elapsed_ns == 0) ? 0.0 : total_ns * 100 / elapsed_ns);
+    }
+}
+
+#else /* !CHESS_PROFILE */
+
+void profile_startup(void) {}
+
+void profile_merge_thread(void) {}
+
+void profile_print_report(FILE* fp) {
+    fprintf(fp,
+            "Profiling is disabled, rebuild with 'make PROFILE=1' to enable "
+            "it.\n");
+}
+
+#endif /* !CHESS_PROFILE */
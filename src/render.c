@@ -18,16 +18,41 @@
 
 #include <stdbool.h>
 #include <assert.h>
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
 #include <curses.h>
 
+#include "include/render.h"
 #include "include/board.h"
+#include "include/clock.h"
+#include "include/index.h"
+#include "include/move.h"
+#include "include/search.h"
 #include "include/util.h"
 
 #define MARGIN_X 2 /* characters */
 #define MARGIN_Y 1 /* characters */
 
+/*
+ * Milliseconds to wait for user input before rendering again, so the clocks and
+ * the analysis are updated even if the user doesn't press any key. Only used if
+ * 'render_startup' is called with 'periodic' set.
+ */
+#define INPUT_TIMEOUT 100
+
+/*
+ * Width of the text of each clock, in characters.
+ */
+#define CLOCK_TEXT_LEN 5
+
+/*
+ * Maximum length of a row of the analysis panel, including the null
+ * terminator.
+ */
+#define ANALYSIS_ROW_MAX 256
+
 /*
  * Enumeration with all possible render colors. These values will be used as IDs
  * for the ncurses colors.
@@ -39,6 +64,9 @@ enum ERenderColors {
     RENDER_COL_PIECE,
     RENDER_COL_BORDER,
     RENDER_COL_SELECTION,
+    RENDER_COL_TARGET,
+    RENDER_COL_CAPTURE,
+    RENDER_COL_ATTACKED,
 
     NUM_RENDER_COLORS, /* Must be last */
 };
@@ -56,6 +84,19 @@ typedef struct {
 
 /*----------------------------------------------------------------------------*/
 
+/*
+ * Screen created by 'render_startup_headless', or NULL if the standard screen
+ * is used.
+ */
+static SCREEN* g_headless_screen = NULL;
+
+/*
+ * Text of each row of the analysis panel in the last frame, so only the rows
+ * that changed are redrawn. The first row is the header, and the rest are the
+ * lines of the search.
+ */
+static char g_analysis_rows[SEARCH_MAX_LINES + 1][ANALYSIS_ROW_MAX];
+
 /*
  * Array with the color configurations for all color categories in the program.
  */
@@ -84,6 +125,24 @@ static const ColorInfo g_render_colors[] = {
       .foreground = COLOR_CYAN,
       .background = COLOR_BLACK,
     },
+    [RENDER_COL_TARGET] = {
+      .is_bold    = false,
+      .is_dim     = false,
+      .foreground = COLOR_GREEN,
+      .background = COLOR_BLACK,
+    },
+    [RENDER_COL_CAPTURE] = {
+      .is_bold    = true,
+      .is_dim     = false,
+      .foreground = COLOR_RED,
+      .background = COLOR_BLACK,
+    },
+    [RENDER_COL_ATTACKED] = {
+      .is_bold    = true,
+      .is_dim     = false,
+      .foreground = COLOR_YELLOW,
+      .background = COLOR_BLACK,
+    },
 };
 
 /*----------------------------------------------------------------------------*/
@@ -193,21 +252,221 @@ static bool addfmt_colored(enum ERenderColors color, const char* fmt, ...) {
     return result;
 }
 
+/*
+ * Render the remaining time of the specified color at the current position,
+ * with the format "MM:SS", or "SS.D" when the remaining time is low.
+ */
+static bool render_clock_time(const GameClock* clock, enum EPieceColor color) {
+    const int64_t remaining = clock_remaining_ms(clock, color);
+
+    const enum ERenderColors render_color =
+      (clock->running == color) ? RENDER_COL_SELECTION : RENDER_COL_DEFAULT;
+
+    /*
+     * The text is padded to a fixed width, since the short format is shorter
+     * than the long one, and the old text would be left on the screen.
+     */
+    char text[CLOCK_TEXT_LEN + 1];
+    if (remaining <= 0) {
+        snprintf(text, sizeof(text), "FLAG");
+    } else if (remaining < 10 * 1000) {
+        snprintf(text,
+                 sizeof(text),
+                 "%02d.%d",
+                 (int)(remaining / 1000),
+                 (int)(remaining / 100 % 10));
+    } else {
+        const int64_t seconds = remaining / 1000;
+        snprintf(text,
+                 sizeof(text),
+                 "%02d:%02d",
+                 (int)(seconds / 60),
+                 (int)(seconds % 60));
+    }
+
+    return addfmt_colored(render_color, "%-*s", CLOCK_TEXT_LEN, text);
+}
+
+/*
+ * Render the clock of each player next to the board, at the side of their
+ * pieces.
+ */
+static bool render_clocks(const Board* board, const GameClock* clock) {
+    const int x = MARGIN_X + (STRLEN("+---") * board->width) + 1 + MARGIN_X;
+
+    move(MARGIN_Y + 1, x);
+    if (!render_clock_time(clock, PIECE_COL_BLACK))
+        return false;
+
+    move(MARGIN_Y + (STRLEN("+|") * board->height) - 1, x);
+    if (!render_clock_time(clock, PIECE_COL_WHITE))
+        return false;
+
+    return true;
+}
+
+/*
+ * Render the results of the games with the current position below the board.
+ */
+static bool render_stats(const Board* board, const IndexEntry* stats) {
+    move(MARGIN_Y + (STRLEN("+|") * board->height) + 2, MARGIN_X);
+    clrtoeol();
+
+    const uint64_t games = index_entry_games(stats);
+    if (games == 0)
+        return addfmt_colored(RENDER_COL_DEFAULT, "No games");
+
+    return addfmt_colored(RENDER_COL_DEFAULT,
+                          "%llu games: %.1f%% white, %.1f%% draw, "
+                          "%.1f%% black",
+                          (unsigned long long)games,
+                          stats->white_wins * 100.0 / games,
+                          stats->draws * 100.0 / games,
+                          stats->black_wins * 100.0 / games);
+}
+
+/*
+ * Render a line of text below the board, after the position stats.
+ */
+static bool render_status(const Board* board, const char* status) {
+    move(MARGIN_Y + (STRLEN("+|") * board->height) + 3, MARGIN_X);
+    clrtoeol();
+
+    return addfmt_colored(RENDER_COL_DEFAULT, "%s", status);
+}
+
+/*
+ * Write the specified score, from the point of view of white, to a buffer of
+ * the specified size, either in pawns or as the moves until a forced mate.
+ */
+static void format_score(char* dst, size_t size, int score) {
+    if (search_is_mate_score(score)) {
+        const int plies = SEARCH_SCORE_MATE - abs(score);
+        snprintf(dst, size, "#%s%d", (score < 0) ? "-" : "", (plies + 1) / 2);
+    } else {
+        snprintf(dst, size, "%+.2f", score / 100.0);
+    }
+}
+
+/*
+ * Write a line of the search to a buffer of the specified size, with as many
+ * moves as they fit.
+ */
+static void format_line(char* dst, size_t size, size_t index,
+                        const SearchLine* line) {
+    char score[16];
+    format_score(score, sizeof(score), line->score);
+
+    int written = snprintf(dst, size, "%zu. %6s", index + 1, score);
+    for (size_t i = 0; i < line->length; i++) {
+        if (written < 0 || (size_t)written + 1 + MOVE_STR_MAX > size)
+            break;
+
+        char move_str[MOVE_STR_MAX];
+        move_to_str(&line->moves[i], move_str);
+        written += snprintf(dst + written, size - written, " %s", move_str);
+    }
+}
+
+/*
+ * Render a row of the analysis panel, only if its text is different from the
+ * last frame.
+ */
+static bool render_analysis_row(int y, int x, size_t row, const char* text) {
+    if (strcmp(g_analysis_rows[row], text) == 0)
+        return true;
+    strcpy(g_analysis_rows[row], text);
+
+    move(y, x);
+    clrtoeol();
+    return addfmt_colored(RENDER_COL_DEFAULT, "%s", text);
+}
+
+/*
+ * Render the lines of the analysis in a panel next to the board, between the
+ * clocks.
+ */
+static bool render_analysis(const Board* board, const SearchResult* analysis) {
+    const int x = MARGIN_X + (STRLEN("+---") * board->width) + 1 + MARGIN_X;
+    const int y = MARGIN_Y + 3;
+
+    /* Truncate the rows to the width of the terminal */
+    size_t width = (COLS > x) ? (size_t)(COLS - x) + 1 : 1;
+    if (width > ANALYSIS_ROW_MAX)
+        width = ANALYSIS_ROW_MAX;
+
+    char text[ANALYSIS_ROW_MAX];
+    if (analysis->depth == 0)
+        snprintf(text, width, "Analyzing...");
+    else if (analysis->num_lines == 0)
+        snprintf(text, width, "No legal moves");
+    else
+        snprintf(text,
+                 width,
+                 "Depth %d, %llu nodes",
+                 analysis->depth,
+                 (unsigned long long)analysis->nodes);
+
+    if (!render_analysis_row(y, x, 0, text))
+        return false;
+
+    for (size_t i = 0; i < SEARCH_MAX_LINES; i++) {
+        if (i < analysis->num_lines)
+            format_line(text, width, i, &analysis->lines[i]);
+        else
+            text[0] = '\0';
+
+        if (!render_analysis_row(y + 1 + i, x, i + 1, text))
+            return false;
+    }
+
+    return true;
+}
+
 /*----------------------------------------------------------------------------*/
 
-bool render_startup(void) {
-    return initscr() != NULL && /* Init ncurses */
-           raw() != ERR &&      /* Scan input without pressing enter */
-           noecho() != ERR &&   /* Don't print when typing */
-           keypad(stdscr, true) != ERR && /* Enable keypad (arrow keys) */
-           init_colors();                 /* Initialize ncurses color pairs */
+bool render_startup(bool periodic) {
+    if (!(initscr() != NULL && /* Init ncurses */
+          raw() != ERR &&      /* Scan input without pressing enter */
+          noecho() != ERR &&   /* Don't print when typing */
+          keypad(stdscr, true) != ERR && /* Enable keypad (arrow keys) */
+          init_colors()))                /* Initialize ncurses color pairs */
+        return false;
+
+    /* Don't block forever when reading input, see 'INPUT_TIMEOUT' */
+    if (periodic)
+        timeout(INPUT_TIMEOUT);
+
+    /* The screen is empty, so all rows of the analysis need to be drawn */
+    memset(g_analysis_rows, 0, sizeof(g_analysis_rows));
+    return true;
+}
+
+bool render_startup_headless(FILE* output) {
+    /*
+     * Use a fixed terminal type, so the output doesn't depend on $TERM. It
+     * needs more than 8 colors, see 'g_render_colors'.
+     */
+    g_headless_screen = newterm("xterm-256color", output, stdin);
+    if (g_headless_screen == NULL)
+        return false;
+
+    memset(g_analysis_rows, 0, sizeof(g_analysis_rows));
+    return init_colors();
 }
 
 void render_cleanup(void) {
     endwin();
+
+    if (g_headless_screen != NULL) {
+        delscreen(g_headless_screen);
+        g_headless_screen = NULL;
+    }
 }
 
-bool render_board(const Board* board) {
+bool render_board(const Board* board, const RenderInfo* info) {
+    const MoveCache* move_cache = (info != NULL) ? info->move_cache : NULL;
+
     move(MARGIN_Y, MARGIN_X);
 
     /* Initial border */
@@ -224,16 +483,42 @@ bool render_board(const Board* board) {
             if (!addfmt_colored(RENDER_COL_BORDER, "| "))
                 return false;
 
-            const enum ERenderColors piece_color =
-              (board->selection.x != BOARD_COL_NONE &&
-               board->selection.y != BOARD_ROW_NONE &&
-               x == board->selection.x && y == board->selection.y)
-                ? RENDER_COL_SELECTION
-                : RENDER_COL_PIECE;
-
             const BoardCoordinate coord = { .x = x, .y = y };
-            const char piece_char =
-              board_cell_get_char(board_cell_at(board, coord));
+            char piece_char = board_cell_get_char(board_cell_at(board, coord));
+
+            /* The highlights are cached, so this doesn't generate moves */
+            enum ERenderColors piece_color;
+            if (board->selection.x != BOARD_COL_NONE &&
+                board->selection.y != BOARD_ROW_NONE &&
+                x == board->selection.x && y == board->selection.y) {
+                piece_color = RENDER_COL_SELECTION;
+            } else {
+                switch (move_cache_get_highlight(move_cache, board, coord)) {
+                    case MOVE_HIGHLIGHT_TARGET:
+                        piece_color = RENDER_COL_TARGET;
+                        piece_char  = '.';
+                        break;
+                    case MOVE_HIGHLIGHT_ATTACKED_TARGET:
+                        piece_color = RENDER_COL_ATTACKED;
+                        piece_char  = '.';
+                        break;
+                    case MOVE_HIGHLIGHT_CAPTURE:
+                        /* En passant captures land on an empty cell */
+                        piece_color = RENDER_COL_CAPTURE;
+                        if (piece_char == ' ')
+                            piece_char = 'x';
+                        break;
+                    case MOVE_HIGHLIGHT_ATTACKED_CAPTURE:
+                        piece_color = RENDER_COL_ATTACKED;
+                        if (piece_char == ' ')
+                            piece_char = 'x';
+                        break;
+                    default:
+                        piece_color = RENDER_COL_PIECE;
+                        break;
+                }
+            }
+
             if (!addfmt_colored(piece_color, "%c", piece_char))
                 return false;
 
@@ -252,6 +537,20 @@ bool render_board(const Board* board) {
             return false;
     }
 
+    if (info != NULL) {
+        if (info->clock != NULL && !render_clocks(board, info->clock))
+            return false;
+
+        if (info->stats != NULL && !render_stats(board, info->stats))
+            return false;
+
+        if (info->status != NULL && !render_status(board, info->status))
+            return false;
+
+        if (info->analysis != NULL && !render_analysis(board, info->analysis))
+            return false;
+    }
+
     /* After rendering, move terminal cursor to the player cursor */
     move(MARGIN_Y + (STRLEN("+|") * board->cursor.y) + 1,
          MARGIN_X + (STRLEN("+---") * board->cursor.x) + 2);
@@ -0,0 +1,232 @@
+/*
+ * Copyright 2025 8dcc
+ *
+ * This file is part of 8dcc's Chess.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+#define _POSIX_C_SOURCE 200809L /* getline */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "include/replay.h"
+#include "include/board.h"
+#include "include/move.h"
+
+/*
+ * Initial number of plies allocated when loading a game.
+ */
+#define INITIAL_PLIES_CAPACITY 256
+
+/*
+ * Characters separating the tokens of a game.
+ */
+#define TOKEN_SEPARATORS " \t\r\n"
+
+/*----------------------------------------------------------------------------*/
+
+/*
+ * Check if the specified token is the result that terminates a game.
+ */
+static bool is_result(const char* token) {
+    return strcmp(token, "1-0") == 0 || strcmp(token, "0-1") == 0 ||
+           strcmp(token, "1/2-1/2") == 0 || strcmp(token, "*") == 0;
+}
+
+/*
+ * Append a copy of the specified board to the keyframes of the replay. Returns
+ * false on error.
+ */
+static bool push_keyframe(Replay* replay, const Board* board) {
+    Board* new_keyframes = realloc(replay->keyframes,
+                                   (replay->num_keyframes + 1) * sizeof(Board));
+    if (new_keyframes == NULL)
+        return false;
+    replay->keyframes = new_keyframes;
+
+    Board* keyframe = &replay->keyframes[replay->num_keyframes];
+    if (!board_init(keyframe, board->width, board->height))
+        return false;
+    board_copy_position(keyframe, board);
+
+    replay->num_keyframes++;
+    return true;
+}
+
+/*
+ * Append a move to the plies of the replay, and make it in the specified board.
+ * Returns false on error.
+ */
+static bool push_move(Replay* replay, Board* board, const Move* move,
+                      size_t* capacity) {
+    if (replay->num_plies >= *capacity) {
+        const size_t new_capacity = *capacity * 2;
+        Move* new_moves = realloc(replay->moves, new_capacity * sizeof(Move));
+        if (new_moves == NULL)
+            return false;
+        replay->moves = new_moves;
+
+        MoveUndo* new_undos =
+          realloc(replay->undos, new_capacity * sizeof(MoveUndo));
+        if (new_undos == NULL)
+            return false;
+        replay->undos = new_undos;
+
+        *capacity = new_capacity;
+    }
+
+    replay->moves[replay->num_plies] = *move;
+    move_make(board, move, &replay->undos[replay->num_plies]);
+    replay->num_plies++;
+
+    /* Store a keyframe with the position before each interval */
+    if (replay->num_plies % REPLAY_KEYFRAME_INTERVAL == 0 &&
+        !push_keyframe(replay, board))
+        return false;
+
+    return true;
+}
+
+/*
+ * Parse the moves of a game from the specified line, which is modified, and
+ * add them to the replay.
+ */
+static bool parse_game(Replay* replay, Board* board, char* line) {
+    size_t capacity = INITIAL_PLIES_CAPACITY;
+    replay->moves   = malloc(capacity * sizeof(Move));
+    replay->undos   = malloc(capacity * sizeof(MoveUndo));
+    if (replay->moves == NULL || replay->undos == NULL)
+        return false;
+
+    if (!push_keyframe(replay, board))
+        return false;
+
+    for (char* token = strtok(line, TOKEN_SEPARATORS); token != NULL;
+         token = strtok(NULL, TOKEN_SEPARATORS)) {
+        /* Move numbers */
+        if (token[strlen(token) - 1] == '.')
+            continue;
+
+        if (is_result(token))
+            break;
+
+        Move move;
+        if (!move_from_str(board, token, &move)) {
+            fprintf(stderr, "Illegal move '%s' in replay.\n", token);
+            return false;
+        }
+
+        if (!push_move(replay, board, &move, &capacity))
+            return false;
+    }
+
+    return true;
+}
+
+/*
+ * Make or unmake the moves of the replay until the specified ply is reached.
+ */
+static void walk_to(Replay* replay, Board* board, size_t ply) {
+    while (replay->ply < ply) {
+        move_make(board,
+                  &replay->moves[replay->ply],
+                  &replay->undos[replay->ply]);
+        replay->ply++;
+    }
+
+    while (replay->ply > ply) {
+        replay->ply--;
+        move_unmake(board,
+                    &replay->moves[replay->ply],
+                    &replay->undos[replay->ply]);
+    }
+}
+
+/*----------------------------------------------------------------------------*/
+
+bool replay_load(Replay* replay, Board* board, const char* path) {
+    replay->moves         = NULL;
+    replay->undos         = NULL;
+    replay->num_plies     = 0;
+    replay->keyframes     = NULL;
+    replay->num_keyframes = 0;
+    replay->ply           = 0;
+
+    FILE* fp = fopen(path, "r");
+    if (fp == NULL)
+        return false;
+
+    /* Use the first line that is not empty */
+    char* line       = NULL;
+    size_t line_size = 0;
+    bool found_line  = false;
+    while (getline(&line, &line_size, fp) != -1) {
+        if (line[strspn(line, TOKEN_SEPARATORS)] != '\0') {
+            found_line = true;
+            break;
+        }
+    }
+    fclose(fp);
+
+    const bool result = found_line && parse_game(replay, board, line);
+    free(line);
+    if (!result) {
+        replay_destroy(replay);
+        return false;
+    }
+
+    /* The moves were already made while parsing, go back to the start */
+    replay->ply = replay->num_plies;
+    replay_seek(replay, board, 0);
+    return true;
+}
+
+void replay_destroy(Replay* replay) {
+    for (size_t i = 0; i < replay->num_keyframes; i++)
+        board_destroy(&replay->keyframes[i]);
+
+    free(replay->keyframes);
+    free(replay->moves);
+    free(replay->undos);
+
+    replay->keyframes     = NULL;
+    replay->moves         = NULL;
+    replay->undos         = NULL;
+    replay->num_keyframes = 0;
+    replay->num_plies     = 0;
+}
+
+void replay_seek(Replay* replay, Board* board, size_t ply) {
+    if (ply > replay->num_plies)
+        ply = replay->num_plies;
+
+    /*
+     * Walk from the current position if it's closer than the previous
+     * keyframe, which is always the case when stepping a single ply.
+     * Otherwise, restore the keyframe and make the remaining moves.
+     */
+    const size_t keyframe       = ply / REPLAY_KEYFRAME_INTERVAL;
+    const size_t keyframe_moves = ply % REPLAY_KEYFRAME_INTERVAL;
+    const size_t current_moves =
+      (ply > replay->ply) ? ply - replay->ply : replay->ply - ply;
+
+    if (current_moves > keyframe_moves) {
+        board_copy_position(board, &replay->keyframes[keyframe]);
+        replay->ply = keyframe * REPLAY_KEYFRAME_INTERVAL;
+    }
+    walk_to(replay, board, ply);
+}
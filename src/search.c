@@ -0,0 +1,310 @@
+/*
+ * Copyright 2025 8dcc
+ *
+ * This file is part of 8dcc's Chess.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "include/search.h"
+#include "include/board.h"
+#include "include/eval.h"
+#include "include/move.h"
+#include "include/piece.h"
+#include "include/profile.h"
+#include "include/rules.h"
+#include "include/timeman.h"
+
+/*
+ * Score added to captures and promotions when ordering moves, so they are
+ * always searched before quiet moves.
+ */
+#define ORDER_TACTICAL_BONUS 100000
+
+/*
+ * Value of the halfmove clock that ends the game with a draw (fifty-move rule).
+ */
+#define FIFTY_MOVE_PLIES 100
+
+/*----------------------------------------------------------------------------*/
+
+/*
+ * Check if the search should stop, because it was requested or because the
+ * deadline of the time manager was reached. Once it returns true, it keeps
+ * returning true for the rest of the search.
+ */
+static inline bool should_stop(Search* search) {
+    if (search->stopped)
+        return true;
+
+    if (__atomic_load_n(&search->stop_requested, __ATOMIC_RELAXED) != 0 ||
+        (search->timeman != NULL &&
+         timeman_check_nodes(search->timeman, search->nodes)))
+        search->stopped = true;
+
+    return search->stopped;
+}
+
+/*
+ * Return the ordering score of the specified move. Captures are ordered by the
+ * value of the captured piece first, and by the value of the moved piece
+ * second (MVV-LVA).
+ */
+static int order_score(const Board* board, const Move* move) {
+    int result = 0;
+
+    if (move->flags & MOVE_FLAG_CAPTURE) {
+        const BoardCell* attacker = board_cell_at(board, move->from);
+        const enum EPieceType victim =
+          (move->flags & MOVE_FLAG_EN_PASSANT)
+            ? PIECE_TYPE_PAWN
+            : board_cell_at(board, move->to)->piece.type;
+
+        result += ORDER_TACTICAL_BONUS + g_eval_material[victim] * 16 -
+                  g_eval_material[attacker->piece.type];
+    }
+
+    if (move->flags & MOVE_FLAG_PROMOTION)
+        result += ORDER_TACTICAL_BONUS + g_eval_material[move->promotion];
+
+    return result;
+}
+
+/*
+ * Move the best move of the list, starting at the specified index, to that
+ * index. Sorting lazily is cheaper than sorting the whole list, since most
+ * nodes are cut off after a few moves.
+ */
+static void pick_next_move(MoveList* list, int* scores, size_t index) {
+    size_t best = index;
+    for (size_t i = index + 1; i < list->count; i++)
+        if (scores[i] > scores[best])
+            best = i;
+
+    if (best == index)
+        return;
+
+    const Move tmp_move = list->moves[index];
+    list->moves[index]  = list->moves[best];
+    list->moves[best]   = tmp_move;
+
+    const int tmp_score = scores[index];
+    scores[index]       = scores[best];
+    scores[best]        = tmp_score;
+}
+
+/*
+ * Store the principal variation of the specified ply, starting with the
+ * specified move and followed by the one of the next ply.
+ */
+static void update_pv(Search* search, size_t ply, const Move* move) {
+    search->pv[ply][0] = *move;
+    memcpy(&search->pv[ply][1],
+           search->pv[ply + 1],
+           search->pv_length[ply + 1] * sizeof(Move));
+    search->pv_length[ply] = search->pv_length[ply + 1] + 1;
+}
+
+/*
+ * Instantiate 'quiescence_<name>' and 'negamax_<name>' for each variant, so
+ * the rules of the variant are resolved at compile time. See "rules.h".
+ *
+ * The preprocessor can't include a file for each entry of 'VARIANT_LIST', so
+ * a new variant needs a new block here. Otherwise, the check below fails to
+ * compile, since the marker of that variant is not declared.
+ */
+#define SEARCH_VARIANT standard
+#include "include/search_impl.h"
+#undef SEARCH_VARIANT
+
+#define SEARCH_VARIANT king_of_the_hill
+#include "include/search_impl.h"
+#undef SEARCH_VARIANT
+
+#define CHECK_INSTANTIATED(NAME, VARIANT) +search_instantiated_##NAME
+enum { SEARCH_NUM_INSTANTIATED = 0 VARIANT_LIST(CHECK_INSTANTIATED) };
+
+#define DISPATCH_NEGAMAX(NAME, VARIANT)                                        \
+    case VARIANT:                                                              \
+        return negamax_##NAME(search, depth, ply, alpha, beta);
+
+/*
+ * Call the 'negamax' function of the variant of the search board. Only used at
+ * the root, the rest of the tree uses the instance of the variant directly.
+ */
+static int negamax(Search* search, int depth, size_t ply, int alpha,
+                   int beta) {
+    switch (search->board.variant) {
+        VARIANT_LIST(DISPATCH_NEGAMAX)
+    }
+
+    return 0;
+}
+
+/*
+ * Insert a line into the array of lines, which is sorted by score and has the
+ * specified capacity, removing the worst line if it's full.
+ */
+static void insert_line(SearchLine* lines, size_t* num_lines, size_t capacity,
+                        const SearchLine* line) {
+    size_t i = (*num_lines < capacity) ? (*num_lines)++ : capacity - 1;
+    for (; i > 0 && lines[i - 1].score < line->score; i--)
+        lines[i] = lines[i - 1];
+
+    lines[i] = *line;
+}
+
+/*----------------------------------------------------------------------------*/
+
+bool search_init(Search* search, const Board* board, size_t num_lines) {
+    if (!board_init(&search->board, board->width, board->height))
+        return false;
+    board_copy_position(&search->board, board);
+
+    search->num_lines =
+      (num_lines > SEARCH_MAX_LINES) ? SEARCH_MAX_LINES : num_lines;
+    search->timeman        = NULL;
+    search->stop_requested = 0;
+    search->stopped        = false;
+    search->nodes          = 0;
+
+    /* The first iteration searches the tactical moves first */
+    MoveList list;
+    move_generate_legal(&search->board, &list);
+    for (size_t i = 0; i < list.count; i++) {
+        search->root_moves[i].move = list.moves[i];
+        search->root_moves[i].score =
+          order_score(&search->board, &list.moves[i]);
+    }
+    search->num_root_moves = list.count;
+
+    return true;
+}
+
+void search_destroy(Search* search) {
+    board_destroy(&search->board);
+}
+
+bool search_iterate(Search* search, int depth, SearchResult* dst) {
+    PROFILE_BEGIN(PROFILE_SPAN_SEARCH);
+
+    Board* board = &search->board;
+
+    /* Sort the root moves by the scores of the previous iteration */
+    for (size_t i = 1; i < search->num_root_moves; i++) {
+        const SearchRootMove root_move = search->root_moves[i];
+        size_t j                       = i;
+        for (; j > 0 && search->root_moves[j - 1].score < root_move.score; j--)
+            search->root_moves[j] = search->root_moves[j - 1];
+        search->root_moves[j] = root_move;
+    }
+
+    /*
+     * Each root move is searched once, and its score is only exact if it's
+     * better than the worst of the lines found so far, which is used as the
+     * alpha bound. That way, the lines share the work of searching the root
+     * moves, instead of searching them again for each line.
+     */
+    SearchLine lines[SEARCH_MAX_LINES];
+    size_t num_lines = 0;
+
+    for (size_t i = 0; i < search->num_root_moves; i++) {
+        SearchRootMove* root_move = &search->root_moves[i];
+
+        const int alpha = (num_lines < search->num_lines)
+                            ? -SEARCH_SCORE_INFINITE
+                            : lines[num_lines - 1].score;
+
+        MoveUndo undo;
+        move_make(board, &root_move->move, &undo);
+        const int score =
+          -negamax(search, depth - 1, 1, -SEARCH_SCORE_INFINITE, -alpha);
+        move_unmake(board, &root_move->move, &undo);
+
+        if (search->stopped) {
+            PROFILE_END(PROFILE_SPAN_SEARCH);
+            return false;
+        }
+
+        root_move->score = score;
+        if (score <= alpha)
+            continue;
+
+        SearchLine line;
+        line.score    = score;
+        line.moves[0] = root_move->move;
+        memcpy(&line.moves[1],
+               search->pv[1],
+               search->pv_length[1] * sizeof(Move));
+        line.length = search->pv_length[1] + 1;
+        insert_line(lines, &num_lines, search->num_lines, &line);
+    }
+
+    /* The scores of the result are from the point of view of white */
+    dst->depth     = depth;
+    dst->nodes     = search->nodes;
+    dst->num_lines = num_lines;
+    for (size_t i = 0; i < num_lines; i++) {
+        dst->lines[i] = lines[i];
+        if (board->turn == PIECE_COL_BLACK)
+            dst->lines[i].score = -dst->lines[i].score;
+    }
+
+    PROFILE_END(PROFILE_SPAN_SEARCH);
+    return true;
+}
+
+bool search_run(Search* search, TimeManager* timeman, int max_depth,
+                SearchResult* dst, SearchIterationCallback callback,
+                void* data) {
+    search->timeman = timeman;
+
+    if (max_depth > SEARCH_MAX_PLY - 1)
+        max_depth = SEARCH_MAX_PLY - 1;
+
+    bool completed = false;
+    SearchResult result;
+    for (int depth = 1; depth <= max_depth; depth++) {
+        if (!search_iterate(search, depth, &result))
+            break;
+
+        const bool best_move_changed =
+          !completed || result.num_lines == 0 || dst->num_lines == 0 ||
+          !move_equal(&result.lines[0].moves[0], &dst->lines[0].moves[0]);
+
+        *dst      = result;
+        completed = true;
+        if (callback != NULL)
+            callback(dst, data);
+
+        /* Positions without legal moves don't need deeper iterations */
+        if (result.num_lines == 0)
+            break;
+
+        if (timeman != NULL &&
+            !timeman_should_deepen(timeman, best_move_changed))
+            break;
+    }
+
+    search->timeman = NULL;
+    return completed;
+}
+
+void search_stop(Search* search) {
+    __atomic_store_n(&search->stop_requested, 1, __ATOMIC_RELAXED);
+}
@@ -0,0 +1,654 @@
+/*
+ * Copyright 2025 8dcc
+ *
+ * This file is part of 8dcc's Chess.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#define _POSIX_C_SOURCE 200809L /* fcntl, strtok_r */
+
+#include <assert.h>
+#include <errno.h>
+#include <stdarg.h>
+#include <stdbool.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/epoll.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include "include/server.h"
+#include "include/board.h"
+#include "include/move.h"
+#include "include/piece.h"
+
+/*
+ * Maximum number of epoll events processed on each iteration.
+ */
+#define MAX_EVENTS 256
+
+/*
+ * Size of the input and output buffers of each connection. Commands longer
+ * than the input buffer are rejected, and clients that don't read their
+ * messages fast enough to fit in the output buffer are disconnected.
+ */
+#define CONN_INPUT_SIZE  128
+#define CONN_OUTPUT_SIZE 1024
+
+/*
+ * Structure representing a game hosted by the server. To keep the memory usage
+ * of idle games low, the position is stored packed as a FEN string, and it's
+ * only unpacked into 'g_board' while processing a move.
+ */
+typedef struct ServerGame {
+    uint32_t id;
+    char fen[BOARD_FEN_MAX];
+
+    /* Connections of each player, white first, or NULL */
+    struct ServerConn* players[2];
+} ServerGame;
+
+/*
+ * Structure representing a client connection.
+ */
+typedef struct ServerConn {
+    int fd;
+
+    /* Game that the client is playing, or NULL */
+    ServerGame* game;
+    enum EPieceColor color;
+
+    /* Received data that doesn't form a full line yet */
+    char input[CONN_INPUT_SIZE];
+    size_t input_len;
+
+    /* Data that couldn't be sent without blocking */
+    char output[CONN_OUTPUT_SIZE];
+    size_t output_len;
+
+    /* True if epoll is reporting EPOLLOUT events for this connection */
+    bool waiting_output;
+} ServerConn;
+
+/*
+ * Array of games, indexed by their ID, or NULL for the IDs of finished games.
+ * Those IDs are stored in 'g_free_ids', and they are reused for new games
+ * before growing the array.
+ */
+static ServerGame** g_games    = NULL;
+static size_t g_games_size     = 0;
+static size_t g_games_capacity = 0;
+static uint32_t* g_free_ids    = NULL;
+static size_t g_free_ids_size  = 0;
+
+/*
+ * Board used for processing the moves of all games, see 'ServerGame'.
+ */
+static Board g_board;
+
+static int g_epoll_fd = -1;
+
+/*----------------------------------------------------------------------------*/
+
+/*
+ * Return the index in 'ServerGame.players' for the specified color.
+ */
+static inline int player_index(enum EPieceColor color) {
+    return (color == PIECE_COL_WHITE) ? 0 : 1;
+}
+
+/*
+ * Return the opponent of the specified connection, or NULL if it's not playing
+ * or if the opponent is not connected.
+ */
+static inline ServerConn* opponent_of(const ServerConn* conn) {
+    if (conn->game == NULL)
+        return NULL;
+
+    return conn->game->players[1 - player_index(conn->color)];
+}
+
+/*
+ * Make the specified connection fail, so it's closed when epoll reports its
+ * next event. Used for closing connections other than the one whose event is
+ * being processed, since its memory might still be referenced.
+ */
+static inline void fail_conn(ServerConn* conn) {
+    shutdown(conn->fd, SHUT_RDWR);
+}
+
+/*
+ * Try to send the pending output of the specified connection. Returns false if
+ * the connection failed.
+ */
+static bool flush_output(ServerConn* conn) {
+    size_t sent = 0;
+    while (sent < conn->output_len) {
+        const ssize_t written = send(conn->fd,
+                                     conn->output + sent,
+                                     conn->output_len - sent,
+                                     MSG_NOSIGNAL);
+        if (written < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+                break;
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+        sent += written;
+    }
+
+    memmove(conn->output, conn->output + sent, conn->output_len - sent);
+    conn->output_len -= sent;
+
+    /* Only wait for EPOLLOUT while there is something to send */
+    const bool should_wait = (conn->output_len > 0);
+    if (should_wait != conn->waiting_output) {
+        struct epoll_event event;
+        event.events   = EPOLLIN | (should_wait ? EPOLLOUT : 0);
+        event.data.ptr = conn;
+        if (epoll_ctl(g_epoll_fd, EPOLL_CTL_MOD, conn->fd, &event) < 0)
+            return false;
+        conn->waiting_output = should_wait;
+    }
+
+    return true;
+}
+
+/*
+ * Queue a formatted message for the specified connection, if it's not NULL.
+ * Messages are sent in 'flush_output', after processing the current event. If
+ * the output buffer is full, the connection is closed.
+ */
+static void send_fmt(ServerConn* conn, const char* fmt, ...) {
+    if (conn == NULL)
+        return;
+
+    const size_t available = CONN_OUTPUT_SIZE - conn->output_len;
+
+    va_list va;
+    va_start(va, fmt);
+    const int written =
+      vsnprintf(conn->output + conn->output_len, available, fmt, va);
+    va_end(va);
+
+    if (written < 0 || (size_t)written >= available) {
+        fail_conn(conn);
+        return;
+    }
+
+    conn->output_len += written;
+}
+
+/*----------------------------------------------------------------------------*/
+
+/*
+ * Create a new game, and store it in the games array. Returns NULL on error.
+ */
+static ServerGame* create_game(void) {
+    /* The free IDs array always has the same capacity as the games array */
+    if (g_free_ids_size == 0 && g_games_size >= g_games_capacity) {
+        const size_t new_capacity =
+          (g_games_capacity == 0) ? 64 : g_games_capacity * 2;
+        ServerGame** new_games =
+          realloc(g_games, new_capacity * sizeof(ServerGame*));
+        if (new_games == NULL)
+            return NULL;
+        g_games = new_games;
+
+        uint32_t* new_free_ids =
+          realloc(g_free_ids, new_capacity * sizeof(uint32_t));
+        if (new_free_ids == NULL)
+            return NULL;
+        g_free_ids       = new_free_ids;
+        g_games_capacity = new_capacity;
+    }
+
+    ServerGame* game = malloc(sizeof(ServerGame));
+    if (game == NULL)
+        return NULL;
+
+    if (!board_set_initial_layout(&g_board) ||
+        !board_get_fen(&g_board, game->fen, sizeof(game->fen))) {
+        free(game);
+        return NULL;
+    }
+
+    game->id = (g_free_ids_size > 0) ? g_free_ids[--g_free_ids_size]
+                                     : g_games_size++;
+    game->players[0] = NULL;
+    game->players[1] = NULL;
+
+    g_games[game->id] = game;
+    return game;
+}
+
+/*
+ * Detach both players from the specified game, and free it. The pending
+ * messages of the players are sent immediately, since they are no longer
+ * reachable as opponents after this call.
+ */
+static void end_game(ServerGame* game) {
+    for (int i = 0; i < 2; i++) {
+        ServerConn* player = game->players[i];
+        if (player == NULL)
+            continue;
+
+        player->game = NULL;
+        if (!flush_output(player))
+            fail_conn(player);
+    }
+
+    g_games[game->id]             = NULL;
+    g_free_ids[g_free_ids_size++] = game->id;
+    free(game);
+}
+
+/*
+ * Remove the specified connection from its game, notifying the opponent. The
+ * game can't continue without one of the players, so it's ended.
+ */
+static void leave_game(ServerConn* conn) {
+    if (conn->game == NULL)
+        return;
+
+    send_fmt(opponent_of(conn), "left\n");
+    end_game(conn->game);
+}
+
+/*
+ * Send the cells that changed between the 'old_cells' array and 'g_board' to
+ * both players of the specified game.
+ */
+static void send_board_diff(ServerGame* game, const BoardCell* old_cells) {
+    const Board* board = &g_board;
+
+    for (int y = 0; y < board->height; y++) {
+        for (int x = 0; x < board->width; x++) {
+            const BoardCoordinate coord = { .x = x, .y = y };
+            const BoardCell* old_cell   = &old_cells[board->width * y + x];
+            const BoardCell* new_cell   = board_cell_at(board, coord);
+
+            if (old_cell->has_piece == new_cell->has_piece &&
+                (!new_cell->has_piece ||
+                 (old_cell->piece.type == new_cell->piece.type &&
+                  old_cell->piece.color == new_cell->piece.color)))
+                continue;
+
+            const char piece_char =
+              new_cell->has_piece ? piece_get_fen_char(&new_cell->piece) : '-';
+            for (int i = 0; i < 2; i++)
+                send_fmt(game->players[i],
+                         "cell %c%d %c\n",
+                         'a' + x,
+                         board->height - y,
+                         piece_char);
+        }
+    }
+}
+
+/*----------------------------------------------------------------------------*/
+
+static void command_new(ServerConn* conn) {
+    if (conn->game != NULL) {
+        send_fmt(conn, "error already playing\n");
+        return;
+    }
+
+    ServerGame* game = create_game();
+    if (game == NULL) {
+        send_fmt(conn, "error out of memory\n");
+        return;
+    }
+
+    game->players[0] = conn;
+    conn->game       = game;
+    conn->color      = PIECE_COL_WHITE;
+    send_fmt(conn, "game %lu white\n", (unsigned long)game->id);
+}
+
+static void command_join(ServerConn* conn, const char* arg) {
+    if (conn->game != NULL) {
+        send_fmt(conn, "error already playing\n");
+        return;
+    }
+
+    char* endptr;
+    const unsigned long id = (arg == NULL) ? 0 : strtoul(arg, &endptr, 10);
+    if (arg == NULL || endptr == arg || *endptr != '\0' ||
+        id >= g_games_size || g_games[id] == NULL) {
+        send_fmt(conn, "error no such game\n");
+        return;
+    }
+
+    ServerGame* game = g_games[id];
+    if (game->players[1] != NULL || game->players[0] == NULL) {
+        send_fmt(conn, "error game is full\n");
+        return;
+    }
+
+    game->players[1] = conn;
+    conn->game       = game;
+    conn->color      = PIECE_COL_BLACK;
+    send_fmt(conn, "game %lu black\n", id);
+    send_fmt(game->players[0], "joined\n");
+}
+
+static void command_move(ServerConn* conn, const char* arg) {
+    ServerGame* game = conn->game;
+    if (game == NULL || opponent_of(conn) == NULL) {
+        send_fmt(conn, "error not playing\n");
+        return;
+    }
+
+    Board* board = &g_board;
+    if (!board_set_fen(board, game->fen)) {
+        send_fmt(conn, "error invalid position\n");
+        return;
+    }
+
+    if (board->turn != conn->color) {
+        send_fmt(conn, "error not your turn\n");
+        return;
+    }
+
+    Move move;
+    if (arg == NULL || !move_from_str(board, arg, &move)) {
+        send_fmt(conn, "error illegal move\n");
+        return;
+    }
+
+    /* Keep a copy of the cells for sending only the changes */
+    BoardCell old_cells[8 * 8];
+    assert(board->width * board->height == 8 * 8);
+    memcpy(old_cells, board->cells, sizeof(old_cells));
+
+    MoveUndo undo;
+    move_make(board, &move, &undo);
+    board_get_fen(board, game->fen, sizeof(game->fen));
+
+    for (int i = 0; i < 2; i++)
+        send_fmt(game->players[i], "move %s\n", arg);
+    send_board_diff(game, old_cells);
+
+    /* Check if the game ended, so both players can start another one */
+    MoveList list;
+    move_generate_legal(board, &list);
+    if (list.count == 0) {
+        const char* reason =
+          move_in_check(board, board->turn) ? "checkmate" : "stalemate";
+        for (int i = 0; i < 2; i++)
+            send_fmt(game->players[i], "end %s\n", reason);
+        end_game(game);
+    }
+}
+
+static void command_fen(ServerConn* conn) {
+    if (conn->game == NULL) {
+        send_fmt(conn, "error not playing\n");
+        return;
+    }
+
+    send_fmt(conn, "fen %s\n", conn->game->fen);
+}
+
+static void command_leave(ServerConn* conn) {
+    if (conn->game == NULL) {
+        send_fmt(conn, "error not playing\n");
+        return;
+    }
+
+    leave_game(conn);
+}
+
+/*
+ * Process a single line received from the specified connection. Returns false
+ * if the connection should be closed.
+ */
+static bool process_line(ServerConn* conn, char* line) {
+    char* saveptr;
+    const char* command = strtok_r(line, " \t\r", &saveptr);
+    const char* arg     = strtok_r(NULL, " \t\r", &saveptr);
+
+    if (command == NULL)
+        return true;
+
+    if (strcmp(command, "new") == 0)
+        command_new(conn);
+    else if (strcmp(command, "join") == 0)
+        command_join(conn, arg);
+    else if (strcmp(command, "move") == 0)
+        command_move(conn, arg);
+    else if (strcmp(command, "fen") == 0)
+        command_fen(conn);
+    else if (strcmp(command, "leave") == 0)
+        command_leave(conn);
+    else if (strcmp(command, "quit") == 0)
+        return false;
+    else
+        send_fmt(conn, "error unknown command\n");
+
+    return true;
+}
+
+/*----------------------------------------------------------------------------*/
+
+/*
+ * Close the specified connection, and free it.
+ */
+static void close_conn(ServerConn* conn) {
+    /* The opponent is notified and its pending messages are sent here */
+    leave_game(conn);
+    epoll_ctl(g_epoll_fd, EPOLL_CTL_DEL, conn->fd, NULL);
+    close(conn->fd);
+    free(conn);
+}
+
+/*
+ * Read all available data from the specified connection, and process all
+ * complete lines. Returns false if the connection should be closed.
+ */
+static bool handle_input(ServerConn* conn) {
+    for (;;) {
+        const ssize_t received =
+          recv(conn->fd,
+               conn->input + conn->input_len,
+               CONN_INPUT_SIZE - conn->input_len,
+               0);
+        if (received == 0)
+            return false;
+        if (received < 0) {
+            if (errno == EAGAIN || errno == EWOULDBLOCK)
+                return true;
+            if (errno == EINTR)
+                continue;
+            return false;
+        }
+        conn->input_len += received;
+
+        /* Process each complete line */
+        size_t start = 0;
+        for (size_t i = 0; i < conn->input_len; i++) {
+            if (conn->input[i] != '\n')
+                continue;
+
+            conn->input[i] = '\0';
+            if (!process_line(conn, &conn->input[start]))
+                return false;
+            start = i + 1;
+        }
+
+        memmove(conn->input, conn->input + start, conn->input_len - start);
+        conn->input_len -= start;
+
+        /* The line is too long to fit in the buffer */
+        if (conn->input_len >= CONN_INPUT_SIZE)
+            return false;
+    }
+}
+
+/*
+ * Accept all pending connections of the listening socket.
+ */
+static void accept_connections(int listen_fd) {
+    for (;;) {
+        const int fd = accept(listen_fd, NULL, NULL);
+        if (fd < 0)
+            return;
+
+        ServerConn* conn = malloc(sizeof(ServerConn));
+        if (conn == NULL || fcntl(fd, F_SETFL, O_NONBLOCK) < 0) {
+            free(conn);
+            close(fd);
+            continue;
+        }
+
+        conn->fd         = fd;
+        conn->game       = NULL;
+        conn->color      = PIECE_COL_UNKNOWN;
+        conn->input_len      = 0;
+        conn->output_len     = 0;
+        conn->waiting_output = false;
+
+        struct epoll_event event;
+        event.events   = EPOLLIN;
+        event.data.ptr = conn;
+        if (epoll_ctl(g_epoll_fd, EPOLL_CTL_ADD, fd, &event) < 0) {
+            free(conn);
+            close(fd);
+        }
+    }
+}
+
+/*
+ * Create a non-blocking socket listening on the specified port. Returns -1 on
+ * error.
+ */
+static int create_listen_socket(uint16_t port) {
+    const int fd = socket(AF_INET, SOCK_STREAM, 0);
+    if (fd < 0)
+        return -1;
+
+    const int enable = 1;
+    setsockopt(fd, SOL_SOCKET, SO_REUSEADDR, &enable, sizeof(enable));
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family      = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_ANY);
+    addr.sin_port        = htons(port);
+
+    if (bind(fd, (struct sockaddr*)&addr, sizeof(addr)) < 0 ||
+        listen(fd, SOMAXCONN) < 0 || fcntl(fd, F_SETFL, O_NONBLOCK) < 0) {
+        close(fd);
+        return -1;
+    }
+
+    return fd;
+}
+
+/*----------------------------------------------------------------------------*/
+
+bool server_run(uint16_t port) {
+    const int listen_fd = create_listen_socket(port);
+    if (listen_fd < 0) {
+        fprintf(stderr,
+                "Failed to listen on port %u: %s\n",
+                port,
+                strerror(errno));
+        return false;
+    }
+
+    g_epoll_fd = epoll_create1(0);
+    if (g_epoll_fd < 0) {
+        fprintf(stderr,
+                "Failed to create epoll instance: %s\n",
+                strerror(errno));
+        close(listen_fd);
+        return false;
+    }
+
+    /* The listening socket is identified by a NULL pointer */
+    struct epoll_event event;
+    event.events   = EPOLLIN;
+    event.data.ptr = NULL;
+    if (epoll_ctl(g_epoll_fd, EPOLL_CTL_ADD, listen_fd, &event) < 0) {
+        fprintf(stderr,
+                "Failed to add socket to epoll: %s\n",
+                strerror(errno));
+        close(g_epoll_fd);
+        close(listen_fd);
+        return false;
+    }
+
+    if (!board_init(&g_board, 8, 8)) {
+        fprintf(stderr, "Failed to initialize the board.\n");
+        close(g_epoll_fd);
+        close(listen_fd);
+        return false;
+    }
+
+    printf("Listening on port %u.\n", port);
+    fflush(stdout);
+
+    struct epoll_event events[MAX_EVENTS];
+    for (;;) {
+        const int num_events = epoll_wait(g_epoll_fd, events, MAX_EVENTS, -1);
+        if (num_events < 0) {
+            if (errno == EINTR)
+                continue;
+            fprintf(stderr,
+                    "Failed to wait for events: %s\n",
+                    strerror(errno));
+            break;
+        }
+
+        for (int i = 0; i < num_events; i++) {
+            ServerConn* conn = events[i].data.ptr;
+            if (conn == NULL) {
+                accept_connections(listen_fd);
+                continue;
+            }
+
+            /*
+             * Process the input of this client, and send the queued messages
+             * to it and to its opponent, which might have changed.
+             */
+            bool is_open = !(events[i].events & (EPOLLERR | EPOLLHUP)) &&
+                           (!(events[i].events & EPOLLIN) ||
+                            handle_input(conn));
+            if (!is_open) {
+                close_conn(conn);
+                continue;
+            }
+
+            ServerConn* opponent = opponent_of(conn);
+            if (opponent != NULL && !flush_output(opponent))
+                fail_conn(opponent);
+            if (!flush_output(conn))
+                close_conn(conn);
+        }
+    }
+
+    board_destroy(&g_board);
+    close(g_epoll_fd);
+    close(listen_fd);
+    return false;
+}
@@ -0,0 +1,124 @@
+/*
+ * Copyright 2025 8dcc
+ *
+ * This file is part of 8dcc's Chess.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#include "include/timeman.h"
+#include "include/clock.h"
+#include "include/piece.h"
+
+/*
+ * Estimated number of moves left in the game, used for dividing the remaining
+ * time when the time control has no moves-to-go.
+ */
+#define ESTIMATED_MOVES_TO_GO 30
+
+/*
+ * Time reserved for the overhead of the program (rendering, input, etc.) that
+ * is not accounted by the search, in milliseconds.
+ */
+#define MOVE_OVERHEAD_MS 50
+
+/*
+ * Maximum multiplier of the soft deadline used for the hard deadline.
+ */
+#define HARD_DEADLINE_FACTOR 4
+
+/*----------------------------------------------------------------------------*/
+
+void timeman_init(TimeManager* timeman, const GameClock* clock,
+                  enum EPieceColor color) {
+    int64_t remaining = clock_remaining_ms(clock, color) - MOVE_OVERHEAD_MS;
+    if (remaining < 1)
+        remaining = 1;
+
+    int moves_to_go = clock_moves_left(clock, color);
+    if (moves_to_go <= 0 || moves_to_go > ESTIMATED_MOVES_TO_GO)
+        moves_to_go = ESTIMATED_MOVES_TO_GO;
+
+    /*
+     * Use an even share of the remaining time, plus most of the increment,
+     * which will be received back after the move.
+     */
+    int64_t soft = remaining / moves_to_go + clock->increment_ms * 3 / 4;
+    if (soft > remaining)
+        soft = remaining;
+
+    /*
+     * The hard deadline allows the current iteration to finish if it's taking
+     * longer than expected, but it never uses more than a fraction of the
+     * remaining time.
+     */
+    const int64_t hard_cap = (remaining / 2 > soft) ? remaining / 2 : soft;
+    int64_t hard           = soft * HARD_DEADLINE_FACTOR;
+    if (hard > hard_cap)
+        hard = hard_cap;
+
+    timeman->start_ms  = clock_now_ms();
+    timeman->soft_ms   = soft;
+    timeman->hard_ms   = hard;
+    timeman->stability = 0;
+    timeman->stopped   = false;
+
+    timeman->stop_when_stable = true;
+}
+
+void timeman_init_fixed(TimeManager* timeman, int64_t move_ms) {
+    timeman->start_ms  = clock_now_ms();
+    timeman->soft_ms   = move_ms;
+    timeman->hard_ms   = move_ms;
+    timeman->stability = 0;
+    timeman->stopped   = false;
+
+    timeman->stop_when_stable = false;
+}
+
+int64_t timeman_elapsed_ms(const TimeManager* timeman) {
+    return clock_now_ms() - timeman->start_ms;
+}
+
+bool timeman_check_hard(TimeManager* timeman) {
+    if (timeman_elapsed_ms(timeman) >= timeman->hard_ms)
+        timeman->stopped = true;
+
+    return timeman->stopped;
+}
+
+bool timeman_should_deepen(TimeManager* timeman, bool best_move_changed) {
+    if (timeman->stopped)
+        return false;
+
+    timeman->stability = best_move_changed ? 0 : timeman->stability + 1;
+
+    const int64_t elapsed = timeman_elapsed_ms(timeman);
+    if (elapsed >= timeman->soft_ms)
+        return false;
+
+    /*
+     * If the best move has been stable for a while, and we already used a
+     * good part of the soft limit, the next iteration will probably not change
+     * it, so we can save the time for later moves.
+     */
+    if (timeman->stop_when_stable &&
+        timeman->stability >= TIMEMAN_STABLE_ITERATIONS &&
+        elapsed >= timeman->soft_ms / 4)
+        return false;
+
+    return true;
+}
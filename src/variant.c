@@ -0,0 +1,49 @@
+/*
+ * Copyright 2025 8dcc
+ *
+ * This file is part of 8dcc's Chess.
+ *
+ * This program is free software: you can redistribute it and/or modify it under
+ * the terms of the GNU General Public License as published by the Free Software
+ * Foundation, either version 3 of the License, or any later version.
+ *
+ * This program is distributed in the hope that it will be useful, but WITHOUT
+ * ANY WARRANTY; without even the implied warranty of MERCHANTABILITY or FITNESS
+ * FOR A PARTICULAR PURPOSE. See the GNU General Public License for more
+ * details.
+ *
+ * You should have received a copy of the GNU General Public License along with
+ * this program. If not, see <https://www.gnu.org/licenses/>.
+ */
+
+#include <stdbool.h>
+#include <string.h>
+
+#include "include/variant.h"
+#include "include/util.h"
+
+/*
+ * Names of each variant, as accepted by 'variant_from_str'. Some variants have
+ * more than one name.
+ */
+static const struct {
+    const char* name;
+    enum EVariant variant;
+} g_variant_names[] = {
+    { "standard", VARIANT_STANDARD },
+    { "king-of-the-hill", VARIANT_KING_OF_THE_HILL },
+    { "koth", VARIANT_KING_OF_THE_HILL },
+};
+
+/*----------------------------------------------------------------------------*/
+
+bool variant_from_str(const char* str, enum EVariant* dst) {
+    for (size_t i = 0; i < ARRLEN(g_variant_names); i++) {
+        if (strcmp(str, g_variant_names[i].name) == 0) {
+            *dst = g_variant_names[i].variant;
+            return true;
+        }
+    }
+
+    return false;
+}